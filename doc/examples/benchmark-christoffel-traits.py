@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+#
+# Benchmark for the restricted Christoffel contraction (ChristoffelTraits).
+#
+# For each analytic metric, time Metric::diff() on a random geodesic
+# state, once through Generic::diff(), which contracts all 64
+# Christoffel symbols ("dense"), and once through the metric's own
+# diff(), which only contracts its non-zero symbols ("traits"). The
+# loop runs in C++ (the repeat argument of the Python diff()), so the
+# figures do not include the cost of the Python call.
+#
+# python/tests/std.py (TestChristoffelTraits) checks that both give
+# the same result.
+#
+# Usage: benchmark-christoffel-traits.py [repeat]
+
+import sys
+import time
+import numpy
+import gyoto.core
+import gyoto.std
+
+n=int(sys.argv[1]) if len(sys.argv)>1 else 200000
+
+bl=gyoto.std.KerrBL()
+bl.spin(0.7)
+ks=gyoto.std.KerrKS()
+ks.spin(0.7)
+mks=gyoto.std.Minkowski()
+mks.spherical(True)
+mkc=gyoto.std.Minkowski()
+mkc.spherical(False)
+metrics={'KerrBL': (bl, True), 'KerrKS': (ks, False),
+         'Minkowski spherical': (mks, True),
+         'Minkowski Cartesian': (mkc, False)}
+
+rng=numpy.random.RandomState(0)
+for name, (met, spherical) in metrics.items():
+    r=rng.uniform(4., 20.)
+    th=rng.uniform(0.3, numpy.pi-0.3)
+    ph=rng.uniform(0., 2.*numpy.pi)
+    if spherical:
+        pos=[0., r, th, ph]
+    else:
+        pos=[0., r*numpy.sin(th)*numpy.cos(ph),
+             r*numpy.sin(th)*numpy.sin(ph), r*numpy.cos(th)]
+    vel=rng.uniform(-0.1, 0.1, 4)
+    vel[0]=rng.uniform(1., 2.)
+    x=gyoto.core.vector_double(pos+vel.tolist())
+    dxdt=gyoto.core.vector_double(8)
+    t={}
+    for dense in (True, False):
+        start=time.time()
+        met.diff(x, dxdt, 0., dense, n)
+        t[dense]=(time.time()-start)/n*1e9
+    print("%20s: dense %6.1f ns, traits %6.1f ns (x%.2f)"
+          % (name, t[True], t[False], t[True]/t[False]))
@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+#
+# Memory used by the per-thread clones of a large PatternDisk.
+#
+# With ThreadPool set, a Scenery keeps one clone of its Astrobj per
+# thread between calls to rayTrace(). The clones of a PatternDisk
+# share its tables, so that the resident memory should not grow with
+# NThreads. Ray-trace a small image of a 64 MB PatternDisk with 1 to
+# maxthreads threads and report the resident set size (from
+# /proc/self/statm, hence Linux only) above that before ray-tracing.
+#
+# python/tests/std.py (TestPatternDisk.test_shared_storage) checks
+# that the clones share the tables.
+#
+# Usage: benchmark-memory-footprint.py [maxthreads]
+
+import sys
+import numpy
+import gyoto.core
+import gyoto.std
+
+maxthreads=int(sys.argv[1]) if len(sys.argv)>1 else 64
+nnu, nphi, nr=1, 512, 16384
+
+statm=open('/proc/self/statm')
+def rss():
+    statm.seek(0)
+    return int(statm.read().split()[1])*4096
+
+gg=gyoto.std.KerrBL()
+pd=gyoto.std.PatternDisk()
+pd.metric(gg)
+pd.innerRadius(3.)
+pd.outerRadius(28.)
+intensity=numpy.ones((nr, nphi, nnu))
+naxes=numpy.asarray([nnu, nphi, nr], dtype=numpy.uintp)
+pd.copyIntensity(gyoto.core.array_double.fromnumpy3(intensity),
+                 gyoto.core.array_size_t.fromnumpy1(naxes))
+del intensity
+
+scr=gyoto.core.Screen()
+scr.metric(gg)
+scr.distance(100.)
+scr.inclination(numpy.pi/4.)
+scr.resolution(8)
+sc=gyoto.core.Scenery()
+sc.metric(gg)
+sc.astrobj(pd)
+sc.screen(scr)
+sc.threadPool(True)
+
+cube=8*nnu*nphi*nr
+print("PatternDisk table: %.1f MB" % (cube/1e6))
+ref=rss()
+nthreads=1
+while nthreads<=maxthreads:
+    sc.nThreads(nthreads)
+    sc.rayTrace()
+    print("NThreads=%i: %.1f MB more than before ray-tracing"
+          % (nthreads, (rss()-ref)/1e6))
+    nthreads*=2
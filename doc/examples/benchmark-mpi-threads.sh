@@ -0,0 +1,44 @@
+#!/bin/bash
+#
+# Scaling benchmark for hybrid MPI + threads ray-tracing.
+#
+# Ray-trace the same Scenery on a fixed number of cores, split in
+# every power-of-two way between MPI worker processes (--nprocesses)
+# and threads per worker (--nthreads), and report the wall-clock time
+# of each run. This time includes spawning the workers and loading the
+# Scenery (and its FITS tables, if any) in each of them. The speed-up
+# is relative to the first run, with one thread per process.
+#
+# Usage: benchmark-mpi-threads.sh [cores [input.xml [resolution]]]
+#
+# For instance, within a SLURM allocation of 4 nodes of 32 cores:
+#   benchmark-mpi-threads.sh 128 example-polish-doughnut.xml 256
+#
+# Set GYOTO to the gyoto executable to use, MPIRUN to the command used
+# to start the manager.
+
+set -e
+
+CORES=${1:-8}
+XMLFILE=${2:-$(dirname $0)/example-polish-doughnut.xml}
+RESOLUTION=${3:-64}
+GYOTO=${GYOTO:-gyoto}
+MPIRUN=${MPIRUN:-mpirun -n 1}
+
+OUTPUT=$(mktemp -d)
+trap "rm -Rf $OUTPUT" EXIT
+
+printf "%8s %8s %12s %12s\n" processes threads "time [s]" "speed-up"
+for ((threads=1; threads<=CORES; threads*=2)); do
+    processes=$((CORES/threads))
+    start=$(date +%s.%N)
+    $MPIRUN $GYOTO --silent --nprocesses=$processes --nthreads=$threads \
+	--resolution=$RESOLUTION $XMLFILE \!$OUTPUT/image.fits
+    end=$(date +%s.%N)
+    time=$(echo "$end - $start" | bc -l)
+    [ -z "$reference" ] && reference=$time
+    printf "%8d %8d %12.3f %12.2f\n" $processes $threads $time \
+	$(echo "$reference / $time" | bc -l)
+done
+
+exit 0
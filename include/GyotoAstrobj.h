@@ -39,6 +39,7 @@
 #include <GyotoSmartPointer.h>
 #include <GyotoConverters.h>
 #include <GyotoObject.h>
+#include <GyotoHooks.h>
 
 namespace Gyoto{
   class Photon;
@@ -48,6 +49,7 @@ namespace Gyoto{
   namespace Astrobj {
     class Generic;
     class Properties;
+    class BoundingVolume;
 
     /**
      * This is a more specific version of the
@@ -195,7 +197,8 @@ namespace Gyoto{
  */
 class Gyoto::Astrobj::Generic
 : public Gyoto::SmartPointee,
-  public Gyoto::Object
+  public Gyoto::Object,
+  public Gyoto::Hook::Teller
 {
   friend class Gyoto::SmartPointer<Gyoto::Astrobj::Generic>;
 
@@ -213,6 +216,18 @@ private:
    */
   int __defaultfeatures;
 
+  /// Default implementation of radiativeQ(Inu, Taunu, ...)
+  /**
+   * tmp receives the ten outputs of the polarized radiativeQ() that
+   * are not returned (10*nbnu doubles). processHitQuantities() calls
+   * this directly, with tmp in Photon::scratch(), once it knows that
+   * radiativeQ(Inu, Taunu, ...) is not reimplemented.
+   */
+  void defaultRadiativeQ(double Inu[], double Taunu[], double tmp[],
+			 double const nu_em[], size_t nbnu,
+			 double dsem, state_t const &coord_ph,
+			 double const coord_obj[8]) const;
+
  protected:
 
   /**
@@ -451,6 +466,21 @@ private:
   virtual int Impact(Gyoto::Photon* ph, size_t index,
 		     Astrobj::Properties *data=NULL) = 0 ;
   ///< Does a photon at these coordinates impact the object?
+
+  /// Volume containing the object between two dates
+  /**
+   * Complex::Impact() uses it to skip the elements that a Photon
+   * step cannot reach. The volume must therefore contain every point
+   * where Impact() may find a hit between dates t1 and t2.
+   *
+   * The default is the ball of radius rMax() around the origin, or
+   * no bound at all if rMax() is infinite. Objects that know better
+   * (a star, a thin disk...) should reimplement it.
+   *
+   * \param t1, t2 Coordinate times of the Photon step;
+   * \param bv     Set to the bounding volume.
+   */
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
   
   /**
    * \brief Fills Astrobj::Properties
@@ -812,4 +842,44 @@ class Gyoto::Astrobj::Properties : public Gyoto::SmartPointee {
 # endif
 };
 
+/**
+ * \class Gyoto::Astrobj::BoundingVolume
+ * \brief Simple volume that contains an Astrobj
+ *
+ * Filled by Generic::boundingVolume(). Coordinates are the Cartesian
+ * expression of the Metric coordinates, as returned by
+ * Worldline::getCartesianPos(), in geometrical units.
+ */
+class Gyoto::Astrobj::BoundingVolume {
+ public:
+  /// Kinds of volumes
+  enum Shape {
+    Everywhere, ///< No bound
+    Sphere, ///< Ball of #radius around #center
+    Slab, ///< #zmin &le; z &le; #zmax, at most #radius from the z axis
+    Cone ///< Within #angle of the z axis (either way), at most #radius from the origin
+  };
+  Shape shape; ///< Kind of volume
+  double center[3]; ///< Center of a Sphere
+  double radius; ///< See #Shape
+  double zmin; ///< Bottom of a Slab
+  double zmax; ///< Top of a Slab
+  double angle; ///< Half opening angle of a Cone, in radians
+
+  BoundingVolume(); ///< Everywhere
+  void everywhere(); ///< Set #shape to Everywhere
+  void sphere(double const c[3], double r); ///< Set to a Sphere
+  void slab(double z1, double z2, double r); ///< Set to a Slab
+  void cone(double a, double r); ///< Set to a Cone
+
+  /// Whether a Photon step from p1 to p2 may enter the volume
+  /**
+   * The Photon follows a curve between p1 and p2, not the chord. To
+   * allow for this, the chord is given a thickness of half its
+   * length. The answer is exact for an Everywhere or Sphere volume,
+   * and conservative otherwise.
+   */
+  bool reaches(double const p1[3], double const p2[3]) const;
+};
+
 #endif
@@ -82,6 +82,13 @@ class Gyoto::Spectrum::BlackBody : public Gyoto::Spectrum::Generic {
   using Gyoto::Spectrum::Generic::operator();
   virtual double operator()(double nu) const;
 
+  /// Same as temperature(T) then operator()(nu), leaving temperature() alone
+  /**
+   * Being const, it may be used by several threads at once on a
+   * shared instance.
+   */
+  double operator()(double nu, double T) const;
+
 };
 
 #endif
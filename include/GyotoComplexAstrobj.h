@@ -30,6 +30,8 @@
 
 #include <GyotoAstrobj.h>
 
+#include <vector>
+
 namespace Gyoto{
   namespace Astrobj {
     class Complex;
@@ -70,7 +72,10 @@ namespace Gyoto{
  * \endcode
  *
  */
-class Gyoto::Astrobj::Complex : public Gyoto::Astrobj::Generic {
+class Gyoto::Astrobj::Complex :
+  public Gyoto::Astrobj::Generic,
+  public Gyoto::Hook::Listener
+{
   friend class Gyoto::SmartPointer<Gyoto::Astrobj::Complex>;
   
   // Data : 
@@ -92,8 +97,15 @@ class Gyoto::Astrobj::Complex : public Gyoto::Astrobj::Generic {
    */
   double step_max_; ///< Maximum &delta; step inside the Astrobj
 
+  /// Elements considered by Impact(), kept to spare allocations
+  std::vector<size_t> candidates_;
+
+  /// Whether Impact() skips the elements a step cannot reach
+  bool culling_;
+
  public:
   GYOTO_OBJECT_THREAD_SAFETY;
+  virtual size_t generation() const; ///< Including the elements'
   Complex(); ///< Default constructor.
   Complex(const Complex& ) ; ///< Copy constructor.
   virtual Complex* clone() const; ///< "Virtual" copy constructor
@@ -123,6 +135,15 @@ class Gyoto::Astrobj::Complex : public Gyoto::Astrobj::Generic {
    */
   void append(Gyoto::SmartPointer<Gyoto::Astrobj::Generic> element);
   ///< Add element at the end of the array.
+
+  /// Set whether Impact() uses the bounding volumes (default: true)
+  /**
+   * Turning culling off makes Impact() consider every element at
+   * every step. The result should not change: this is meant for
+   * checking Generic::boundingVolume() implementations.
+   */
+  void culling(bool c);
+  bool culling() const; ///< Whether Impact() uses the bounding volumes
   void remove(size_t i);
   ///< Remove i-th element from the array.
   size_t getCardinal() const;
@@ -131,6 +152,10 @@ class Gyoto::Astrobj::Complex : public Gyoto::Astrobj::Generic {
   void metric(SmartPointer<Metric::Generic> gg);
   ///< Set metric in each element.
 
+ protected:
+  /// Pass on to our listeners that an element has changed
+  virtual void tell(Gyoto::Hook::Teller *msg);
+
  public:
 #ifdef GYOTO_USE_XERCES
   virtual void fillElement(FactoryMessenger *fmp) const ;
@@ -143,18 +168,27 @@ class Gyoto::Astrobj::Complex : public Gyoto::Astrobj::Generic {
 
   /**
    * Astrobj::Complex::Impact(Gyoto::Photon* ph, size_t index,
-   * Astrobj::Properties *data) calls the specific implementation of
-   * Astrobj::Generic::Impact() for each of its
-   * elements twice: the first time, data is set to NULL so that
+   * Astrobj::Properties *data) first skips the elements whose
+   * Generic::boundingVolume() the Photon step cannot reach, unless
+   * culling() is off or MinDistance or FirstDmin are requested.
+   *
+   * If a single element remains, its Impact() is called once,
+   * passing data. This assumes that Impact() does not touch data
+   * when the object is not hit, which holds for all the quantities
+   * except MinDistance and FirstDmin: when those are requested, the
+   * two-pass scheme below is used instead.
+   *
+   * Otherwise, Impact() is called for each remaining element twice:
+   * the first time, data is set to NULL so that
    * Astrobj::Complex::Impact() only knows whether each object is hit
    * by the Photon. If no object is hit, return. If a single object is
    * hit, call Impact() again only for this object, passing data this
    * time. If several objects are hit, the Photon's trajectory is
    * refined so that the step is at most step_max_ and the Impact()
    * methods for each of the hit objects are called again for each
-   * step, passing data. It is therefore important that the
-   * transmission of the Photon is not touched by Impact() when
-   * data==NULL.
+   * step whose bounding volume they may reach, passing data. It is
+   * therefore important that the transmission of the Photon is not
+   * touched by Impact() when data==NULL.
    * 
    */
   virtual int Impact(Gyoto::Photon* ph, size_t index,
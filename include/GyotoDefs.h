@@ -27,6 +27,8 @@
 #include "GyotoConfig.h"
 #include <float.h>
 #include <vector>
+#include <cstddef>
+#include <stdexcept>
 
 /**
  * \brief Replacement for GNU extension sincos
@@ -45,9 +47,121 @@
 # endif
 #endif
 
+/**
+ * \brief Capacity of Gyoto::state_t
+ *
+ * A geodesic state holds 8 doubles (position and tangent vector), or
+ * 16 when parallel transport of the observer screen base vectors is
+ * enabled. Gyoto::state_t is therefore a Gyoto::FixedState of this
+ * capacity.
+ *
+ * There is no separate 8-double type: parallel transport is switched
+ * at run time (Gyoto::Worldline::parallelTransport()) and state_t is
+ * passed through virtual methods such as Gyoto::Metric::Generic::diff(),
+ * so both sizes must share one type. Building with a capacity of 8
+ * made no measurable difference to Star orbits, which use 8 doubles.
+ */
+#define GYOTO_STATE_CAPACITY 16
+
 /* Typedef for various Gyoto data types */
 namespace Gyoto {
-  typedef std::vector<double> state_t;
+  /**
+   * \brief Fixed-capacity vector of doubles
+   *
+   * Drop-in replacement for std::vector<double> for the small,
+   * bounded vectors used in the geodesic integrators. Storage lives
+   * inside the object: constructing, copying or resizing a FixedState
+   * never touches the heap. The size is set at run time and may not
+   * exceed N; std::length_error is thrown otherwise.
+   *
+   * A FixedState converts implicitly from and to std::vector<double>
+   * so that it can be handed to the rest of the API.
+   */
+  template <size_t N>
+  class FixedState {
+  public:
+    typedef double value_type;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef double & reference;
+    typedef double const & const_reference;
+    typedef double * pointer;
+    typedef double const * const_pointer;
+    typedef double * iterator;
+    typedef double const * const_iterator;
+  protected:
+    double data_[N]; ///< Storage
+    size_t size_; ///< Number of elements in use
+    static size_t check(size_t n) {
+      if (n > N) throw std::length_error("Gyoto::FixedState: capacity exceeded");
+      return n;
+    }
+  public:
+    FixedState() : size_(0) {}
+    explicit FixedState(size_t n, double val=0.) : size_(check(n)) {
+      for (size_t i=0; i<size_; ++i) data_[i]=val;
+    }
+    FixedState(double const * first, double const * last)
+      : size_(check(last-first)) {
+      for (size_t i=0; i<size_; ++i) data_[i]=first[i];
+    }
+    FixedState(std::vector<double> const &v) : size_(check(v.size())) {
+      for (size_t i=0; i<size_; ++i) data_[i]=v[i];
+    }
+    FixedState(FixedState const &o) : size_(o.size_) {
+      for (size_t i=0; i<size_; ++i) data_[i]=o.data_[i];
+    }
+    FixedState & operator=(FixedState const &o) {
+      size_=o.size_;
+      for (size_t i=0; i<size_; ++i) data_[i]=o.data_[i];
+      return *this;
+    }
+    operator std::vector<double>() const
+    { return std::vector<double>(data_, data_+size_); }
+
+    static size_t capacity() { return N; }
+    static size_t max_size() { return N; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_==0; }
+    void clear() { size_=0; }
+    void resize(size_t n, double val=0.) {
+      check(n);
+      for (size_t i=size_; i<n; ++i) data_[i]=val;
+      size_=n;
+    }
+    void assign(size_t n, double val) {
+      size_=check(n);
+      for (size_t i=0; i<size_; ++i) data_[i]=val;
+    }
+    void push_back(double val) { check(size_+1); data_[size_++]=val; }
+
+    double * data() { return data_; }
+    double const * data() const { return data_; }
+    double & operator[](size_t i) { return data_[i]; }
+    double const & operator[](size_t i) const { return data_[i]; }
+    double & front() { return data_[0]; }
+    double const & front() const { return data_[0]; }
+    double & back() { return data_[size_-1]; }
+    double const & back() const { return data_[size_-1]; }
+    iterator begin() { return data_; }
+    const_iterator begin() const { return data_; }
+    iterator end() { return data_+size_; }
+    const_iterator end() const { return data_+size_; }
+    bool operator==(FixedState const &o) const {
+      if (size_!=o.size_) return false;
+      for (size_t i=0; i<size_; ++i) if (data_[i]!=o.data_[i]) return false;
+      return true;
+    }
+    bool operator!=(FixedState const &o) const { return !(*this==o); }
+  };
+
+  /**
+   * \brief State of a geodesic: 8 or 16 doubles
+   *
+   * Stored on the stack, see Gyoto::FixedState and
+   * #GYOTO_STATE_CAPACITY.
+   */
+  typedef FixedState<GYOTO_STATE_CAPACITY> state_t;
 
   //\{
   /**
@@ -422,6 +536,92 @@ namespace Gyoto {
  */
 #define GYOTO_DEFAULT_MAXITER 100000
 
+/**
+ * \brief Default value for Gyoto::Scenery::tile_size_
+ *
+ * Number of consecutive rays handed out at once by the work-stealing
+ * scheduler of Gyoto::Scenery::rayTrace().
+ */
+#define GYOTO_DEFAULT_TILE_SIZE 64
+
+/**
+ * \brief Maximum number of rays in an adaptive MPI chunk
+ *
+ * When Gyoto::Scenery::mpi_chunk_size_ is 0, Gyoto::Scenery::rayTrace()
+ * sends at most that many rays at once to each MPI worker.
+ */
+#define GYOTO_MPI_CHUNK_MAX 1024
+
+/**
+ * \brief Target duration of an adaptive MPI chunk, in seconds
+ *
+ * When Gyoto::Scenery::mpi_chunk_size_ is 0, Gyoto::Scenery::rayTrace()
+ * sizes the chunks sent to the MPI workers so that each of them takes
+ * about that long to compute, given the cost per ray measured so far.
+ */
+#define GYOTO_MPI_CHUNK_SECONDS 0.05
+
+/**
+ * \brief Maximum number of rays in a Gyoto::Photon::Packet
+ *
+ * Also the stride of the structure-of-arrays buffers passed to
+ * Gyoto::Metric::Generic::diffPacket() and
+ * Gyoto::Metric::Generic::christoffelPacket().
+ */
+#define GYOTO_PACKET_MAX 16
+
+/**
+ * \brief Width of the vectorized loops over a Gyoto::Photon::Packet
+ *
+ * The packet kernels (Gyoto::Metric::Generic::geodesicPacket(),
+ * Gyoto::Metric::KerrBL::christoffelPacket()...) round the number of
+ * rays up to a multiple of this, padding with harmless values, so
+ * that their loops over the packet have no remainder and vectorize
+ * at -O2. Must divide #GYOTO_PACKET_MAX.
+ */
+#define GYOTO_PACKET_LANES 8
+
+/**
+ * \def GYOTO_PACKET_TARGETS
+ * \brief Compile a packet kernel for several instruction sets
+ *
+ * On x86-64 Linux with GCC, a function defined with this attribute
+ * is compiled for AVX-512, AVX2 and the baseline instruction set, and
+ * the best version the processor supports is picked at load time
+ * (function multi-versioning). Elsewhere, it is empty and the kernels
+ * are compiled for whatever the build flags target. Virtual
+ * functions cannot be multi-versioned: they call functions defined
+ * with it.
+ *
+ * \def GYOTO_PACKET_INLINE
+ * \brief Force inlining into a #GYOTO_PACKET_TARGETS function
+ *
+ * So that helpers are compiled for the same instruction sets.
+ *
+ * \def GYOTO_PACKET_UNROLL
+ * \brief Fully unroll the next (short) loop
+ *
+ * A loop over the points of a packet only vectorizes if the loops
+ * nested in it are unrolled, which GCC does not always do at -O2.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) \
+  && defined(__linux__) && defined(__has_attribute)
+# if __has_attribute(target_clones)
+#  define GYOTO_PACKET_TARGETS \
+  __attribute__((target_clones("avx512f", "avx2", "default")))
+# endif
+#endif
+#ifndef GYOTO_PACKET_TARGETS
+# define GYOTO_PACKET_TARGETS
+#endif
+#ifdef __GNUC__
+# define GYOTO_PACKET_INLINE inline __attribute__((always_inline))
+# define GYOTO_PACKET_UNROLL _Pragma("GCC unroll 16")
+#else
+# define GYOTO_PACKET_INLINE inline
+# define GYOTO_PACKET_UNROLL
+#endif
+
 /**
  * \brief Precision on the determination of a date
  *
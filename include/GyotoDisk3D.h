@@ -63,16 +63,16 @@ class Gyoto::Astrobj::Disk3D : public Gyoto::Astrobj::Generic {
    * z and last r. It typically contains temperature and is used only by
    * subclasses.
    */
-  double * emissquant_; ///< Physical quantity yielding emission.
+  SharedArray<double> emissquant_; ///< Physical quantity yielding emission.
 
-  double * opacity_; ///< Opacity, same dimensions as emissquant_
+  SharedArray<double> opacity_; ///< Opacity, same dimensions as emissquant_
 
   /**
    * An array of dimensionality double[nr_][nz_][nphi_][3]. In FITS format,
    * the second dimension is phi, the third z and last r. The first plane in
    * the first FITS dimention is dphi/dt, the second dz/dt the last dr/dt.
    */
-  double * velocity_; ///< Velocity(r, z, phi)
+  SharedArray<double> velocity_; ///< Velocity(r, z, phi)
 
   double dnu_; ///< Frequency scale of PatternDisk::emission_ in Hz
   double nu0_; ///< Lowest frequency provided in PatternDisk::emission_ in Hz
@@ -145,23 +145,23 @@ class Gyoto::Astrobj::Disk3D : public Gyoto::Astrobj::Generic {
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void setEmissquant(double * pattern);
+  void setEmissquant(double const * pattern);
 
-  void opacity(double * pattern);
+  void opacity(double const * pattern); ///< Borrow Disk3D::opacity_
 
   /// Set Disk3D::velocity__.
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void setVelocity(double * pattern);
+  void setVelocity(double const * pattern);
 
   /// Set Disk3D::emissquant_.
   /**
@@ -261,6 +261,28 @@ class Gyoto::Astrobj::Disk3D : public Gyoto::Astrobj::Generic {
   void getIndices(size_t i[4], double const co[4], double nu=0.) const ;
   ///< Get emissquant_ cell corresponding to position co[4].
 
+  /// Get the arrays themselves
+  /**
+   * For derived classes that keep several sets of arrays, such as
+   * DynamicalDisk3D. The arrays are shared, not copied.
+   */
+  SharedArray<double> const & emissquantArray() const;
+  SharedArray<double> const & opacityArray() const; ///< Get Disk3D::opacity_
+  SharedArray<double> const & velocityArray() const; ///< Get Disk3D::velocity_
+
+  /// Get fluid 4-velocity at point from a given velocity array
+  /**
+   * Does the work of getVelocity(double const pos[4], double vel[4])
+   * without touching the object, so that derived classes may supply
+   * their own array.
+   *
+   * \param[in] pos 4-position at which to compute velocity;
+   * \param[out] vel 4-velocity at pos;
+   * \param[in] velocity array laid out as Disk3D::velocity_.
+   */
+  void getVelocity(double const pos[4], double vel[4],
+		   double const * velocity) const;
+
  public:
   int Impact(Photon *ph, size_t index, Astrobj::Properties *data);
 
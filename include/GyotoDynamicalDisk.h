@@ -38,6 +38,7 @@ namespace Gyoto{
 
 //#include <GyotoMetric.h>
 #include <GyotoPatternDiskBB.h>
+#include <GyotoTimeSliceCache.h>
 
 /**
  * \class Gyoto::Astrobj::DynamicalDisk
@@ -46,6 +47,10 @@ namespace Gyoto{
  *   This class describes a PatternDiskBB that evolves dynamically. 
  *   It is described by a set of FITS files.
  *
+ *   The FITS files are read when first needed and kept in a
+ *   TimeSliceCache, shared by the clones, within the memory budget
+ *   set by the CacheBudget property.
+ *
  */
 class Gyoto::Astrobj::DynamicalDisk : public Astrobj::PatternDiskBB {
   friend class Gyoto::SmartPointer<Gyoto::Astrobj::DynamicalDisk>;
@@ -56,14 +61,19 @@ class Gyoto::Astrobj::DynamicalDisk : public Astrobj::PatternDiskBB {
   int nb_times_; ///< Number of dates
   int nnu_, nphi_, nr_; ///< Grid dimensions (assumed constant)
 
-  /// Array of PatternDisk::emission_ arrays
-  double ** emission_array_;
+  /// Time slices {emission, velocity, radius}, shared by clones
+  SmartPointer<TimeSliceCache> cache_;
 
-  /// Array of PatternDisk::velocity_ arrays
-  double ** velocity_array_; ///< 
+  size_t cache_budget_; ///< Memory budget of #cache_ in bytes, 0 for unlimited
+  bool prefetch_; ///< Whether #cache_ reads adjacent dates ahead
 
-  /// Array of PatternDisk::radius_ arrays
-  double ** radius_array_; ///< radius vector
+  /// The two last slices used by copyQuantities()
+  /**
+   * emission() and getVelocity() alternate between two dates: keeping
+   * them here spares a lookup in #cache_ for every call.
+   */
+  TimeSliceCache::Slice slice_[2];
+  int slice_index_[2]; ///< Dates of #slice_ (from 1), 0 if none
 
   // Constructors - Destructor
   // -------------------------
@@ -88,6 +98,16 @@ class Gyoto::Astrobj::DynamicalDisk : public Astrobj::PatternDiskBB {
   void dt(double t);
   double dt()const;
 
+  /// Set the memory budget for the time slices, in bytes (0: unlimited)
+  void cacheBudget(size_t bytes);
+  size_t cacheBudget() const; ///< Get memory budget for the time slices
+  /// Whether to read the dates adjacent to the last one used ahead of time
+  void prefetch(bool p);
+  bool prefetch() const; ///< Get whether dates are read ahead of time
+  size_t cacheHits() const; ///< Time slice requests served from memory
+  size_t cacheMisses() const; ///< Time slice requests that read a file
+  size_t cachePrefetched() const; ///< Time slices read in the background
+
   using PatternDiskBB::emission;
   virtual double emission(double nu_em, double dsem,
 			  state_t const &c_ph, double const c_obj[8]=NULL) const;
@@ -39,6 +39,7 @@ namespace Gyoto{
 
 #include <GyotoDisk3D.h>
 #include <GyotoBlackBodySpectrum.h>
+#include <GyotoTimeSliceCache.h>
 
 /**
  * \class Gyoto::Astrobj::DynamicalDisk3D
@@ -54,6 +55,10 @@ namespace Gyoto{
  *  
  *   The metric must be Kerr in BL coordinates.
  *
+ *   The FITS files are read when first needed and kept in a
+ *   TimeSliceCache, shared by the clones, within the memory budget
+ *   set by the CacheBudget property.
+ *
  */
 class Gyoto::Astrobj::DynamicalDisk3D : public Astrobj::Disk3D {
   friend class Gyoto::SmartPointer<Gyoto::Astrobj::DynamicalDisk3D>;
@@ -71,26 +76,14 @@ class Gyoto::Astrobj::DynamicalDisk3D : public Astrobj::Disk3D {
   double floortemperature_; ///< if non-zero, emission and absorption are 0 for temperatures below this floor, emission=blackbody and absorption is infty for temperatures above (this is a kind of fake optically thick case, when the emitting surface is inside the grid, not at the boundary of the grid)
 
   /**
-   * An array of arrays of dimensionality double[nr_][nz_][nphi_][nnu_]. 
-   * In FITS format, the first dimension is nu, the second phi, the third
-   * z, the last r. It contains emission coef, or a closely related quantity.
+   * Time slices {emission, velocity[, absorption]}, shared by clones.
+   * See Disk3D::emissquant_, Disk3D::velocity_ and Disk3D::opacity_
+   * for the layout of each array.
    */
-  double ** emission_array_;
+  SmartPointer<TimeSliceCache> cache_;
 
-  /**
-   * An array of arrays of dimensionality double[nr_][nz_][nphi_][nnu_]. 
-   * In FITS format, the first dimension is nu, the second phi, the third
-   * z, the last r. It contains absorption coef, or a closely related quantity.
-   */
-  double ** absorption_array_;
-
-  /**
-   * An array of arrays of dimensionality double[nr_][nz_][nphi_][3].
-   * In FITS format, the second dimension is phi, and the third r. 
-   * The first plane in the first FITS dimention is dphi/dt, 
-   * the second dz/dt, the third dr/dt.
-   */
-  double ** velocity_array_; ///< velocity(r, z, phi)
+  size_t cache_budget_; ///< Memory budget of #cache_ in bytes, 0 for unlimited
+  bool prefetch_; ///< Whether #cache_ reads adjacent dates ahead
 
   // Constructors - Destructor
   // -------------------------
@@ -125,11 +118,25 @@ class Gyoto::Astrobj::DynamicalDisk3D : public Astrobj::Disk3D {
   void withVelocity(bool t);
   bool withVelocity() const;
 
+  /// Set the memory budget for the time slices, in bytes (0: unlimited)
+  void cacheBudget(size_t bytes);
+  size_t cacheBudget() const; ///< Get memory budget for the time slices
+  /// Whether to read the dates adjacent to the last one used ahead of time
+  void prefetch(bool p);
+  bool prefetch() const; ///< Get whether dates are read ahead of time
+  size_t cacheHits() const; ///< Time slice requests served from memory
+  size_t cacheMisses() const; ///< Time slice requests that read a file
+  size_t cachePrefetched() const; ///< Time slices read in the background
+
   // Stuff
   // -----
   /// Compute emission at one grid date.
-  double emission1date(double nu_em, double dsem,
-		  state_t const &c_ph, double const c_obj[8]) const;
+  /**
+   * \param quantities the time slice of this date, see slice().
+   */
+  double emission1date(TimeSliceCache::Slice const &quantities,
+		       double nu_em, double dsem,
+		       state_t const &c_ph, double const c_obj[8]) const;
 
   using Disk3D::emission;
   /// Interpolate emission between grid dates.
@@ -137,8 +144,12 @@ class Gyoto::Astrobj::DynamicalDisk3D : public Astrobj::Disk3D {
 			  state_t const &c_ph, double const c_obj[8]=NULL) const;
 
   /// Compute transmission at one grid date.
-  double transmission1date(double nu_em, double dsem,
-		  state_t const &c_ph, double const c_obj[8]) const;
+  /**
+   * \param quantities the time slice of this date, see slice().
+   */
+  double transmission1date(TimeSliceCache::Slice const &quantities,
+			   double nu_em, double dsem,
+			   state_t const &c_ph, double const c_obj[8]) const;
 
   /// Interpolate transmission between grid dates.
   double transmission(double nu_em, double dsem,
@@ -149,11 +160,24 @@ class Gyoto::Astrobj::DynamicalDisk3D : public Astrobj::Disk3D {
   
  protected:
 
-  /// Set underlying Disk3D pointers to a specific date slice.
+  /// Date slice to use at a given time.
+  /**
+   * Computed from #tinit_ and #dt_. Between two dates, the
+   * quantities are interpolated between date(time)-1 and date(time),
+   * except before the first date and after the last but one, where
+   * date(time) is used alone.
+   *
+   * \param time Coordinate time.
+   * \return Index of the date slice, from 1 to #nb_times_.
+   */
+  int date(double time) const;
+
+  /// Get a specific date slice.
   /**
-   * \param iq Index of the date slice.
+   * \param iq Index of the date slice, from 1.
+   * \return {emission, velocity[, absorption]}, shared with #cache_.
    */
-  void copyQuantities(int iq) ;
+  TimeSliceCache::Slice slice(int iq) const;
 
 };
 
@@ -0,0 +1,108 @@
+/**
+ * \file GyotoFitsMap.h
+ * \brief Memory-mapped and in-memory FITS files
+ *
+ *  Map the data unit of a FITS image HDU into memory instead of
+ *  reading it, or read whole FITS files from a copy in memory.
+ */
+
+/*
+  Copyright 2026 Thibaut Paumard
+
+  This file is part of Gyoto.
+
+  Gyoto is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Gyoto is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gyoto.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __GyotoFitsMap_H_
+#define __GyotoFitsMap_H_
+
+#include "GyotoConfig.h"
+#include "GyotoSmartPointer.h"
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+#ifdef GYOTO_USE_CFITSIO
+#include <fitsio.h>
+
+namespace Gyoto {
+  /// Map the current image HDU of fptr into memory
+  /**
+   * Returns an empty SharedArray unless FITS mapping is on (see
+   * Gyoto::fitsMap(int)) and the current HDU of fptr is an
+   * uncompressed image of exactly n doubles (BITPIX=-64, no BSCALE
+   * or BZERO) stored in a plain file. The caller then reads the data
+   * as usual, e.g. with fits_read_subset().
+   *
+   * FITS data are big-endian. On big-endian hosts, the data unit is
+   * mapped directly. Elsewhere, it is converted once into a
+   * native-endian cache file next to the FITS file, named
+   * FILE.hduN.native, which is mapped instead. The cache records
+   * the size, inode and modification time (to the nanosecond) of
+   * FILE and is rewritten when any of them changes. If this cache
+   * cannot be written, the data are not mapped.
+   *
+   * The mapping is private: writing to the data (through
+   * SharedArray::write()) never modifies the files. It remains valid
+   * after fptr is closed, until the last copy of the returned
+   * SharedArray is destroyed.
+   *
+   * \param fptr open FITS file, positioned on an image HDU.
+   * \param n expected number of elements.
+   */
+  SharedArray<double> fitsMapImage(fitsfile * fptr, size_t n);
+
+  /// Open a FITS file read-only, from memory if possible
+  /**
+   * Same as fits_open_file(fptr, name, READONLY, status), except that
+   * if a copy of the file was registered with fitsMemFile(), it is
+   * opened with fits_open_memfile() instead of reading the file
+   * system. Otherwise, the name of the file is remembered (see
+   * fitsOpened()).
+   */
+  int fitsOpen(fitsfile ** fptr, std::string const &name, int * status);
+
+  /// Serve file name from memory
+  /**
+   * Register a copy of file name: size bytes at data. fitsOpen(name)
+   * will read from there until the copy is unregistered by calling
+   * fitsMemFile(name, NULL, 0). data must remain valid until then
+   * and until the files opened from it are closed.
+   *
+   * Scenery::mpiClone() uses this to read the FITS files of a
+   * Scenery once on the manager process and serve them to the
+   * workers through MPI.
+   */
+  void fitsMemFile(std::string const &name, void * data, size_t size);
+
+  /// Names of the regular files opened so far by fitsOpen()
+  std::vector<std::string> fitsOpened();
+
+  /// Lock to hold while reading FITS files outside the main thread
+  /**
+   * cfitsio may only be used by several threads at once if it was
+   * built with --enable-reentrant (see fits_is_reentrant()). Unless
+   * it was, the returned lock holds a global mutex until it goes out
+   * of scope, else it holds nothing.
+   *
+   * The readers of the TimeSliceCache of DynamicalDisk and
+   * DynamicalDisk3D, which may run in background threads, take it.
+   */
+  std::unique_lock<std::mutex> fitsLock();
+}
+#endif
+
+#endif
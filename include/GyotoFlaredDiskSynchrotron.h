@@ -60,13 +60,13 @@ class Gyoto::Astrobj::FlaredDiskSynchrotron
    * format, the first dimension is t, the second phi, and the third
    * r.
    */
-  double * density_; ///< Surface density (&nu;, r, &phi;)
+  SharedArray<double> density_; ///< Surface density (&nu;, r, &phi;)
     /**
    * An array of dimensionality double[nr_][nphi_][nt_][2]. In FITS format,
    * the second dimension is phi, and the third r. The first plane in
    * the first FITS dimention is d&phi;/dt, the second dr/dt.
    */
-  double * velocity_; ///< velocity(r, &phi;)
+  SharedArray<double> velocity_; ///< velocity(r, &phi;)
   double magnetizationParameter_; ///< (B<SUP>2</SUP>/(4 pi)) / (n<SUB>e</SUB> m<SUB>p</SUB> c<SUP>2</SUP>)
   double dt_;///< time translation
 
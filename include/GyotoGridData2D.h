@@ -33,6 +33,8 @@
 #ifdef GYOTO_USE_CFITSIO
 #include <fitsio.h>
 #endif
+#include <vector>
+#include <GyotoSmartPointer.h>
 
 namespace Gyoto {
   class GridData2D;
@@ -65,6 +67,16 @@ class Gyoto::GridData2D
   double tmax_; ///< Maximum t in grid
   //NB: phimin, phimax are always assumed to be 0, 2pi
 
+#ifdef GYOTO_USE_CFITSIO
+  /// Move to HDU extname and set the grid sizes from its dimensions
+  /**
+   * \param naxes set to the dimensions of the HDU
+   * \return the dimensions, as returned by fitsReadHDU()
+   */
+  std::vector<size_t> fitsMoveToHDU(fitsfile* fptr, std::string extname,
+				    size_t length, long naxes[4]);
+#endif
+
  public:
   GridData2D(); ///< Constructor
   GridData2D(const GridData2D&); ///< Copy constructor
@@ -103,6 +115,17 @@ class Gyoto::GridData2D
 					  double *& dest,
 					  size_t length = 0);
 
+  /**
+   * \brief Reads specific HDU in FITS files into a SharedArray
+   *
+   * Same as above, but the data may be mapped from the file instead
+   * of read (see Gyoto::fitsMapImage()).
+   */
+  virtual std::vector<size_t> fitsReadHDU(fitsfile* fptr,
+					  std::string extname,
+					  SharedArray<double> & dest,
+					  size_t length = 0);
+
   /**
    * \brief Creates a FITS file with dummy primary HDU
    *
@@ -148,7 +171,7 @@ class Gyoto::GridData2D
 
   void getIndices(size_t i[3], double const tt, double const phi, double const rr) const ;
   double interpolate(double tt, double phi, double rr,
-		     double* const array) const ;
+		     double const * const array) const ;
     
 
 
@@ -105,6 +105,10 @@ class Gyoto::Metric::Hayward : public Metric::Generic {
   double gmunu_up(const double * const x, int mu, int nu) const ;
   using Generic::christoffel;
   int christoffel(double dst[4][4][4], const double pos[4]) const ;
+  /// Geodesic equation, using CircularChristoffelTraits
+  int diff(state_t const &x, state_t &dxdt, double mass) const ;
+  void diffPacket(double const * x, double * dxdt, int * stop,
+		  size_t n, double mass) const ;
   
   // Optimized
   double ScalarProd(const double pos[4],
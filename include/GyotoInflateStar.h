@@ -96,6 +96,8 @@ class Gyoto::Astrobj::InflateStar :
 
  public:
   
+  /// Same as UniformSphere::boundingVolume() with the largest radius
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
   virtual int Impact(Gyoto::Photon* ph, size_t index,
 		     Astrobj::Properties *data=NULL);
   virtual double emission(double nu_em, double dsem,
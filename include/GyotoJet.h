@@ -147,6 +147,9 @@ class Gyoto::Astrobj::Jet
     
   virtual double operator()(double const coord[4]) ;
 
+  /// Cone of half angle jetOuterOpeningAngle_, up to rMax()
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
+
   virtual void radiativeQ(double Inu[], double Taunu[], 
 			  double const nu_em[], size_t nbnu,
 			  double dsem, state_t const &coord_ph,
@@ -103,9 +103,18 @@ class Gyoto::Metric::KerrBL : public Metric::Generic {
    */
   void gmunu_up(double gup[4][4], const double * pos) const ;
   double gmunu_up(const double * const x, int mu, int nu) const ;
+  /// g<SUP>&mu;&nu;</SUP> and its derivatives in closed form
+  int gmunu_up_jacobian(double gup[4][4], double jac[4][4][4],
+			const double * pos) const ;
  
   using Generic::christoffel;
   int christoffel(double dst[4][4][4], const double pos[4]) const ;
+  void christoffelPacket(double * dst, double const * pos,
+			 int * stop, size_t n) const ;
+  void diffPacket(double const * x, double * dxdt, int * stop,
+		  size_t n, double mass) const ;
+  /// Geodesic equation, using CircularChristoffelTraits
+  int diff(state_t const &x, state_t &dxdt, double mass) const ;
   
   double ScalarProd(const double pos[4],
 		    const double u1[4], const double u2[4]) const ;
@@ -100,9 +100,35 @@ class Gyoto::Metric::KerrKS
    */
   void jacobian(double dst[4][4][4], const double x[4]) const ;
 
+  /**
+   * \brief gmunu_up() and jacobian() at once
+   *
+   * \param[out] gup g<SUP>&mu;&nu;</SUP>
+   * \param[out] jac &part;<SUB>&alpha;</SUB>g<SUB>&mu;&nu;</SUB> in
+   * jac[&alpha;][&mu;][&nu;]
+   * \param[in] pos 4-position
+   */
+  void jacobian(double gup[4][4], double jac[4][4][4],
+		const double pos[4]) const ;
+
+  /**
+   * \brief g<SUP>&mu;&nu;</SUP> and its derivatives
+   *
+   * In Kerr-Schild form, g<SUP>&mu;&nu;</SUP> =
+   * &eta;<SUP>&mu;&nu;</SUP> - f k<SUP>&mu;</SUP>k<SUP>&nu;</SUP> with
+   * k<SUP>&mu;</SUP> = &eta;<SUP>&mu;&alpha;</SUP>k<SUB>&alpha;</SUB>,
+   * so the derivatives follow from jacobian() by a change of sign.
+   */
+  int gmunu_up_jacobian(double gup[4][4], double jac[4][4][4],
+			const double pos[4]) const ;
+
   using Generic::christoffel;
   int christoffel(double dst[4][4][4], const double x[4]) const ;
   int christoffel(double dst[4][4][4], const double pos[4], double gup[4][4], double jac[4][4][4]) const ;
+  void christoffelPacket(double * dst, double const * pos,
+			 int * stop, size_t n) const ;
+  void diffPacket(double const * x, double * dxdt, int * stop,
+		  size_t n, double mass) const ;
 
   virtual void circularVelocity(double const pos[4], double vel [4],
 				double dir=1.) const ;
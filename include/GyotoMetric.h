@@ -129,6 +129,142 @@ namespace Gyoto {
       */
      void initRegister();
 
+    /**
+     * \brief One non-zero Christoffel symbol
+     *
+     * &Gamma;<SUP>A</SUP><SUB>MN</SUB>, with M &le; N since the
+     * symbols are symmetric in their lower indices. Element of a
+     * ChristoffelTraits list.
+     */
+    template<int A, int M, int N> struct ChristoffelTerm {
+      static_assert(0<=A && A<4 && 0<=M && M<=N && N<4,
+		    "ChristoffelTerm<A, M, N> needs 0<=A<4 and 0<=M<=N<4");
+    };
+
+    /**
+     * \brief Compile-time list of the non-zero Christoffel symbols
+     *
+     * A metric which knows which Christoffel symbols are identically
+     * zero lists the others as ChristoffelTerm<A, M, N> parameters
+     * and implements its diff() as Generic::geodesicDiff<Traits>().
+     * The geodesic (and parallel transport) equation is then expanded
+     * at compile time into the listed terms only. The list must
+     * include every component that christoffel(double dst[4][4][4],
+     * const double pos[4]) const may set to a non-zero value.
+     *
+     * ChristoffelTraits<> (the empty list) is the flat space in
+     * Cartesian coordinates.
+     *
+     * contractPacket() is the same contraction for a packet of
+     * geodesics laid out as in Generic::diffPacket(), with the loop
+     * over the packet innermost (see Generic::geodesicPacket()).
+     */
+    template<class... Terms> struct ChristoffelTraits;
+
+    /// \cond INTERNAL
+    template<> struct ChristoffelTraits<> {
+      template<int NVEC>
+      static inline void contract(double const [4][4][4],
+				  double const *, double *) {}
+      static GYOTO_PACKET_INLINE void contractPacket(double const *,
+						     double const *,
+						     double *, size_t) {}
+    };
+
+    template<int A, int M, int N, class... Rest>
+    struct ChristoffelTraits<ChristoffelTerm<A, M, N>, Rest...> {
+      template<int NVEC>
+      static inline void contract(double const dst[4][4][4],
+				  double const * x, double * dxdt) {
+	double const G=dst[A][M][N];
+	for (int v=1; v<=NVEC; ++v)
+	  dxdt[A+4*v] -= (M==N) ?
+	    G*x[4+M]*x[4*v+M] :
+	    G*(x[4+M]*x[4*v+N]+x[4+N]*x[4*v+M]);
+	ChristoffelTraits<Rest...>::template contract<NVEC>(dst, x, dxdt);
+      }
+      static GYOTO_PACKET_INLINE void contractPacket(double const * dst,
+						     double const * x,
+						     double * dxdt, size_t n) {
+	size_t const P=GYOTO_PACKET_MAX;
+	double const * G=dst+((A*4+M)*4+N)*P;
+	double const * xm=x+(4+M)*P, * xn=x+(4+N)*P;
+	double * out=dxdt+(4+A)*P;
+	for (size_t k=0; k<n; ++k)
+	  out[k] -= (M==N) ?
+	    G[k]*xm[k]*xn[k] :
+	    G[k]*(xm[k]*xn[k]+xn[k]*xm[k]);
+	ChristoffelTraits<Rest...>::contractPacket(dst, x, dxdt, n);
+      }
+    };
+    /// \endcond
+
+    /**
+     * \brief ChristoffelTraits for an arbitrary metric
+     *
+     * All 40 independent components.
+     */
+    struct DenseChristoffelTraits {
+      template<int NVEC>
+      static inline void contract(double const dst[4][4][4],
+				  double const * x, double * dxdt) {
+	for (int a=0; a<4; ++a)
+	  for (int v=1; v<=NVEC; ++v) {
+	    double acc=0.;
+	    for (int m=0; m<4; ++m) {
+	      acc += dst[a][m][m]*x[4+m]*x[4*v+m];
+	      for (int n=m+1; n<4; ++n)
+		acc += dst[a][m][n]*(x[4+m]*x[4*v+n]+x[4+n]*x[4*v+m]);
+	    }
+	    dxdt[a+4*v] -= acc;
+	  }
+      }
+      static GYOTO_PACKET_INLINE void contractPacket(double const * dst,
+						     double const * x,
+						     double * dxdt, size_t n) {
+	size_t const P=GYOTO_PACKET_MAX;
+	double acc[GYOTO_PACKET_MAX];
+	for (int a=0; a<4; ++a) {
+	  for (size_t k=0; k<n; ++k) acc[k]=0.;
+	  for (int m=0; m<4; ++m) {
+	    double const * xm=x+(4+m)*P;
+	    double const * G=dst+((a*4+m)*4+m)*P;
+	    for (size_t k=0; k<n; ++k) acc[k] += G[k]*xm[k]*xm[k];
+	    for (int nn=m+1; nn<4; ++nn) {
+	      double const * xn=x+(4+nn)*P;
+	      G=dst+((a*4+m)*4+nn)*P;
+	      for (size_t k=0; k<n; ++k)
+		acc[k] += G[k]*(xm[k]*xn[k]+xn[k]*xm[k]);
+	    }
+	  }
+	  double * out=dxdt+(4+a)*P;
+	  for (size_t k=0; k<n; ++k) out[k] -= acc[k];
+	}
+      }
+    };
+
+    /**
+     * \brief ChristoffelTraits for circular spacetimes
+     *
+     * Stationary, axisymmetric spacetimes without meridional
+     * currents, in (t, r, &theta;, &phi;) coordinates (e.g. KerrBL,
+     * Hayward): &Gamma;<SUP>&alpha;</SUP><SUB>&mu;&nu;</SUB> vanishes
+     * unless an even number of its indices are t or &phi;. This
+     * leaves 20 of the 40 independent components.
+     */
+    typedef ChristoffelTraits<
+      ChristoffelTerm<0,0,1>, ChristoffelTerm<0,0,2>,
+      ChristoffelTerm<0,1,3>, ChristoffelTerm<0,2,3>,
+      ChristoffelTerm<1,0,0>, ChristoffelTerm<1,0,3>,
+      ChristoffelTerm<1,1,1>, ChristoffelTerm<1,1,2>,
+      ChristoffelTerm<1,2,2>, ChristoffelTerm<1,3,3>,
+      ChristoffelTerm<2,0,0>, ChristoffelTerm<2,0,3>,
+      ChristoffelTerm<2,1,1>, ChristoffelTerm<2,1,2>,
+      ChristoffelTerm<2,2,2>, ChristoffelTerm<2,3,3>,
+      ChristoffelTerm<3,0,1>, ChristoffelTerm<3,0,2>,
+      ChristoffelTerm<3,1,3>, ChristoffelTerm<3,2,3>
+      > CircularChristoffelTraits;
+
   }
 
   /* Documented elswhere */
@@ -508,6 +644,42 @@ class Gyoto::Metric::Generic
    */
   virtual void gmunu(double g[4][4], double const pos[4]) const;
 
+  /**
+   * \brief Contravariant metric coefficients
+   *
+   * The default implementation inverts the matrix computed by
+   * gmunu(double g[4][4], double const pos[4]) const. Metrics
+   * which know the inverse in closed form should reimplement it.
+   *
+   * \param[out] gup 4x4 array to store the coefficients
+   * g<SUP>&mu;&nu;</SUP>;
+   * \param[in] pos 4-position at which to compute the coefficients.
+   */
+  virtual void gmunu_up(double gup[4][4], double const pos[4]) const;
+
+  /**
+   * \brief Contravariant metric coefficients and their derivatives
+   *
+   * Used by diffHamiltonian(). Computes g<SUP>&mu;&nu;</SUP> in gup
+   * and &part;<SUB>&alpha;</SUB>g<SUP>&mu;&nu;</SUP> in
+   * jac[&alpha;][&mu;][&nu;].
+   *
+   * The default implementation calls gmunu_up() and christoffel()
+   * and uses &part;<SUB>&alpha;</SUB>g<SUP>&mu;&nu;</SUP> =
+   * -g<SUP>&mu;&beta;</SUP>&Gamma;<SUP>&nu;</SUP><SUB>&beta;&alpha;</SUB>
+   * -g<SUP>&nu;&beta;</SUP>&Gamma;<SUP>&mu;</SUP><SUB>&beta;&alpha;</SUB>.
+   * Metrics which know the inverse in closed form should reimplement
+   * it: the derivatives of g<SUP>&mu;&nu;</SUP> are usually much
+   * cheaper than the 40 Christoffel symbols.
+   *
+   * \param[out] gup 4x4 array to store g<SUP>&mu;&nu;</SUP>;
+   * \param[out] jac 4x4x4 array to store the derivatives;
+   * \param[in] pos 4-position at which to compute them.
+   * \return 1 on error, 0 otherwise
+   */
+  virtual int gmunu_up_jacobian(double gup[4][4], double jac[4][4][4],
+				double const pos[4]) const;
+
 
 
   /**
@@ -531,7 +703,26 @@ class Gyoto::Metric::Generic
    */  
   virtual int christoffel(double dst[4][4][4], const double coord[4]) const ;
 
-
+  /**
+   * \brief Christoffel symbols for a packet of positions
+   *
+   * Structure-of-arrays variant of christoffel(double dst[4][4][4],
+   * const double coord[4]) const for n &le; #GYOTO_PACKET_MAX
+   * points: coordinate &mu; of point k is pos[&mu;*GYOTO_PACKET_MAX+k]
+   * and &Gamma;<SUP>&alpha;</SUP><SUB>&mu;&nu;</SUB> of point k is
+   * stored in dst[((&alpha;*4+&mu;)*4+&nu;)*GYOTO_PACKET_MAX+k]. stop[k]
+   * receives the return value of christoffel() for point k. The
+   * columns of dst past n must be set to finite values, e.g. 0:
+   * geodesicPacket() contracts them too.
+   *
+   * The default implementation calls christoffel() for each point
+   * in turn. Metrics with closed-form symbols should reimplement it
+   * as loops over k up to a multiple of #GYOTO_PACKET_LANES in a
+   * function defined with #GYOTO_PACKET_TARGETS (see
+   * KerrBL::christoffelPacket()).
+   */
+  virtual void christoffelPacket(double * dst, double const * pos,
+				 int * stop, size_t n) const ;
 
   /**
    * \brief RK4 integrator
@@ -574,6 +765,77 @@ class Gyoto::Metric::Generic
   virtual int diff(state_t const &x, state_t &dxdt)  const = delete;
   virtual int diff(const double y[8], double res[8]) const = delete ;
 
+  /**
+   * \brief diff() for a packet of geodesics
+   *
+   * Structure-of-arrays variant of diff(state_t const &x, state_t
+   * &dxdt, double mass) const for n &le; #GYOTO_PACKET_MAX 8-element
+   * states: element i of state k is x[i*GYOTO_PACKET_MAX+k], likewise
+   * for dxdt. stop[k] receives the return value of diff() for state
+   * k. Used by Photon::Packet.
+   *
+   * The default implementation calls diff() for each state in
+   * turn. Metrics which implement diff() as geodesicDiff<Traits>()
+   * should reimplement it as geodesicPacket<Traits>() with the same
+   * Traits, so that both compute the same right-hand side.
+   */
+  virtual void diffPacket(double const * x, double * dxdt, int * stop,
+			  size_t n, double mass) const ;
+
+  /**
+   * \brief Hamiltonian form of the geodesic equation
+   *
+   * Alternative to diff(state_t const &x, state_t &dxdt, double mass)
+   * const where the last four elements of the 8-element state x are
+   * the covariant momentum p<SUB>&mu;</SUB> =
+   * g<SUB>&mu;&nu;</SUB>dx<SUP>&nu;</SUP>/d&lambda; rather than the
+   * 4-velocity. With H = &frac12; g<SUP>&mu;&nu;</SUP>
+   * p<SUB>&mu;</SUB>p<SUB>&nu;</SUB>:
+   *
+   * dx<SUP>&mu;</SUP>/d&lambda; = g<SUP>&mu;&nu;</SUP>p<SUB>&nu;</SUB>,
+   *
+   * dp<SUB>&mu;</SUB>/d&lambda; = -&frac12;
+   * &part;<SUB>&mu;</SUB>g<SUP>&alpha;&beta;</SUP>
+   * p<SUB>&alpha;</SUB>p<SUB>&beta;</SUB>.
+   *
+   * Only the derivatives of the inverse metric are needed (see
+   * gmunu_up_jacobian()), and the momenta conjugate to ignorable
+   * coordinates (e.g. p<SUB>t</SUB> and p<SUB>&phi;</SUB> in KerrBL)
+   * are conserved exactly. Used by the Boost integrators when
+   * Worldline::hamiltonian() is true.
+   *
+   * \return 1 if dt/d&lambda; is below 1e-6 (like diff()) or on
+   * error, 0 otherwise.
+   */
+  virtual int diffHamiltonian(state_t const &x, state_t &dxdt,
+			      double mass) const ;
+
+ protected:
+  /**
+   * \brief Geodesic equation restricted to known non-zero symbols
+   *
+   * Same as Generic::diff(), with the contraction of the Christoffel
+   * symbols expanded at compile time into the terms listed in
+   * Traits (a ChristoffelTraits list or DenseChristoffelTraits).
+   * Metrics reimplement diff() as a call to this with their own
+   * list.
+   */
+  template<class Traits>
+  int geodesicDiff(state_t const &x, state_t &dxdt) const ;
+
+  /**
+   * \brief Geodesic equation for a packet
+   *
+   * Same as geodesicDiff<Traits>(), for a packet laid out as in
+   * diffPacket(), using christoffelPacket() and
+   * Traits::contractPacket(). Compiled for several instruction sets,
+   * see #GYOTO_PACKET_TARGETS.
+   */
+  template<class Traits>
+  void geodesicPacket(double const * x, double * dxdt, int * stop,
+		      size_t n) const ;
+ public:
+
   /**
    * \brief Set Metric-specific constants of motion. Used e.g. in KerrBL.
    */
@@ -583,4 +845,56 @@ class Gyoto::Metric::Generic
 
 };
 
+template<class Traits>
+int Gyoto::Metric::Generic::geodesicDiff(state_t const &x,
+					 state_t &dxdt) const {
+  if (x.size()<8) GYOTO_ERROR("x should have at least 8 elements");
+  if (x.size() != dxdt.size()) GYOTO_ERROR("x.size() should be the same as dxdt.size()");
+  if (x[4]<1e-6) return 1;
+  size_t const nvec = (x.size()-4)/4;
+  dxdt[0]=x[4];
+  dxdt[1]=x[5];
+  dxdt[2]=x[6];
+  dxdt[3]=x[7];
+  for (size_t i=4; i<4*(nvec+1); ++i) dxdt[i]=0.;
+  double dst[4][4][4];
+  int retval=christoffel(dst, x.data());
+  if (retval) return retval;
+  // One instance per number of vectors a state_t can hold
+  switch (nvec) {
+  case 1: Traits::template contract<1>(dst, x.data(), dxdt.data()); break;
+  case 2: Traits::template contract<2>(dst, x.data(), dxdt.data()); break;
+  case 3: Traits::template contract<3>(dst, x.data(), dxdt.data()); break;
+  default: GYOTO_ERROR("state too large for geodesicDiff()");
+  }
+  return 0;
+}
+
+template<class Traits>
+GYOTO_PACKET_TARGETS
+void Gyoto::Metric::Generic::geodesicPacket(double const * x, double * dxdt,
+					    int * stop, size_t n) const {
+  // Same as geodesicDiff() above, with the loop over the packet
+  // innermost. The contraction runs over nv columns, a multiple of
+  // GYOTO_PACKET_LANES, on local copies padded with zeros.
+  size_t const P=GYOTO_PACKET_MAX;
+  size_t const nv=(n+GYOTO_PACKET_LANES-1)
+    /GYOTO_PACKET_LANES*GYOTO_PACKET_LANES;
+  double dst[64*GYOTO_PACKET_MAX], xv[8*GYOTO_PACKET_MAX],
+    acc[8*GYOTO_PACKET_MAX];
+  christoffelPacket(dst, x, stop, n);
+  for (int mu=4; mu<8; ++mu) {
+    for (size_t k=0; k<n; ++k) xv[mu*P+k]=x[mu*P+k];
+    for (size_t k=n; k<nv; ++k) xv[mu*P+k]=0.;
+    for (size_t k=0; k<nv; ++k) acc[mu*P+k]=0.;
+  }
+  Traits::contractPacket(dst, xv, acc, nv);
+  for (int mu=0; mu<4; ++mu)
+    for (size_t k=0; k<n; ++k) {
+      dxdt[mu*P+k]=x[(4+mu)*P+k];
+      dxdt[(4+mu)*P+k]=acc[(4+mu)*P+k];
+    }
+  for (size_t k=0; k<n; ++k) if (x[4*P+k]<1e-6) stop[k]=1;
+}
+
 #endif
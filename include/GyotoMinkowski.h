@@ -62,6 +62,9 @@ class Gyoto::Metric::Minkowski
 
   void gmunu(double g[4][4], const double x[4]) const ;
   int christoffel(double dst[4][4][4], const double x[4]) const ;
+  void gmunu_up(double gup[4][4], const double x[4]) const ;
+  int gmunu_up_jacobian(double gup[4][4], double jac[4][4][4],
+			const double x[4]) const ;
 
   // Those two are implemented as examples.
   double gmunu(const double x[4], int mu, int nu) const ;
@@ -74,6 +77,14 @@ class Gyoto::Metric::Minkowski
 
   // We reimplement diff to be able to integrate Newton's law of motion
   virtual int diff(state_t const &x, state_t &dxdt, double mass) const ;
+  // ... which has no Hamiltonian form
+  virtual int diffHamiltonian(state_t const &x, state_t &dxdt,
+			      double mass) const ;
+  // Packet versions, used by Photon::Packet
+  void christoffelPacket(double * dst, double const * pos,
+			 int * stop, size_t n) const ;
+  void diffPacket(double const * x, double * dxdt, int * stop,
+		  size_t n, double mass) const ;
 
 };
 
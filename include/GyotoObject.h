@@ -171,6 +171,9 @@ class Gyoto::Object
    */
   std::vector<std::string> plugins_;
 
+  /// Number of calls to set(), see generation()
+  size_t generation_;
+
  public:
   /// Whether this class is thread-safe
   /**
@@ -196,6 +199,20 @@ class Gyoto::Object
    */
   virtual bool isThreadSafe() const;
 
+  /// Count of the changes made through set()
+  /**
+   * Incremented each time a Property of this Object is set through
+   * set(), which is what the XML reader and the Python and Yorick
+   * bindings use. The default implementation adds the generation()
+   * of the children declared as properties, like isThreadSafe().
+   * Objects that have other children must take those into account.
+   *
+   * Scenery compares the generation() of its Metric, Astrobj and
+   * Spectrometer before reusing the Photon clones of its thread pool
+   * (see Scenery::threadPool()).
+   */
+  virtual size_t generation() const;
+
 
   GYOTO_OBJECT;
   /** \fn virtual Property const * Object::getProperties() const
@@ -442,6 +459,10 @@ Gyoto::Metric::MyKind::Subcontractor(FactoryMessenger* fmp) {
     * Describe all properties that this instance supports.
     */
    void help() const ;
+
+ private:
+   /// Child Object held by a Metric, Screen, Astrobj, Spectrum or Spectrometer Property
+   SmartPointer<SmartPointee> propertyChild(Property const * prop) const;
 };
 
 #endif
@@ -57,21 +57,21 @@ class Gyoto::Astrobj::PatternDisk : public Astrobj::ThinDisk {
    * format, the first dimension is nu, the second phi, and the third
    * r.
    */
-  double * emission_; ///< I<SUB>&nu;</SUB>(&nu;, r, &phi;)
+  SharedArray<double> emission_; ///< I<SUB>&nu;</SUB>(&nu;, r, &phi;)
 
-  double * opacity_; ///< Same dimenstions as emission, or NULL
+  SharedArray<double> opacity_; ///< Same dimenstions as emission, or NULL
 
   /**
    * An array of dimensionality double[nr_][nphi_][2]. In FITS format,
    * the second dimension is phi, and the third r. The first plane in
    * the first FITS dimention is d&phi;/dt, the second dr/dt.
    */
-  double * velocity_; ///< velocity(r, &phi;)
+  SharedArray<double> velocity_; ///< velocity(r, &phi;)
 
   /**
    * In case of adaptive grid.
    */
-  double * radius_; ///< Radius vector
+  SharedArray<double> radius_; ///< Radius vector
 
   /**
    * XML element: &lt;Omega&gt;.
@@ -147,31 +147,31 @@ class Gyoto::Astrobj::PatternDisk : public Astrobj::ThinDisk {
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void setEmission(double * pattern);
+  void setEmission(double const * pattern);
 
-  /// Set PatternDisk::velocity__
+  /// Set PatternDisk::velocity_
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void setVelocity(double * pattern);
+  void setVelocity(double const * pattern);
 
   /// Set PatternDisk::radius_
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void radius(double * pattern);
+  void radius(double const * pattern);
 
   /// Set PatternDisk::emission_
   /**
@@ -267,6 +267,18 @@ class Gyoto::Astrobj::PatternDisk : public Astrobj::ThinDisk {
   void getIndices(size_t i[3], double const co[4], double nu=0.) const ;
   ///< Get emission_ cell corresponding to position co[4]
 
+  /// Get or set the arrays themselves
+  /**
+   * For derived classes that switch between several sets of arrays,
+   * such as DynamicalDisk. The arrays are shared, not copied.
+   */
+  SharedArray<double> const & emissionArray() const;
+  void emissionArray(SharedArray<double> const &a); ///< Set PatternDisk::emission_
+  SharedArray<double> const & velocityArray() const; ///< Get PatternDisk::velocity_
+  void velocityArray(SharedArray<double> const &a); ///< Set PatternDisk::velocity_
+  SharedArray<double> const & radiusArray() const; ///< Get PatternDisk::radius_
+  void radiusArray(SharedArray<double> const &a); ///< Set PatternDisk::radius_
+
  public:
   using ThinDisk::emission;
   virtual double emission(double nu_em, double dsem,
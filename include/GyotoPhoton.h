@@ -91,9 +91,38 @@ class Gyoto::Photon
    */
   double * transmission_;
 
+  /// Scratch memory for Astrobj::Generic::processHitQuantities()
+  /**
+   * Sized from Photon::spectro_ in _allocateTransmission(), grown
+   * only if scratch() is called with a larger size.
+   */
+  double * scratch_;
+
+  /// Number of doubles in Photon::scratch_
+  size_t scratch_size_;
+
+  /// Number of times Photon::scratch_ has been (re)allocated
+  size_t scratch_allocs_;
+
   /// Nb of crossings of equatorial plane z=0, theta=pi/2
   int nb_cross_eqplane_;
 
+  /// Radius beyond which the Photon is propagated analytically
+  /**
+   * 0 (the default) to always integrate numerically. See
+   * farFieldRadius(double).
+   */
+  double far_field_radius_;
+
+  /// Number of calls to findMin() and findValue() so far
+  size_t find_count_;
+
+  /// Number of evaluations of the object in findMin() and findValue()
+  size_t find_evals_;
+
+  /// Whether findMin() and findValue() use plain bisection
+  bool find_bisection_;
+
   // Constructors - Destructor
   // -------------------------
 
@@ -151,6 +180,28 @@ class Gyoto::Photon
   /// Get Photon::nb_cross_eqplane_
   int nb_cross_eqplane() const;
 
+  /// Set Photon::far_field_radius_
+  /**
+   * When r>0 and the Photon starts (e.g. on the Screen) further than
+   * max(r, object_->rMax()) from the centre, hit() first moves it
+   * analytically down to that radius (see farField()) and rejects it
+   * outright if it is bound to miss the object. This saves the
+   * numerous steps spent crossing the nearly flat region between a
+   * distant observer and the object.
+   *
+   * The approximation is that of a weak, static monopole field: r
+   * should be large compared to the mass and spin of the central
+   * object (say, 1000 geometrical units). The initial condition of
+   * the Photon is replaced by its position at radius r.
+   *
+   * Ignored when integrating forward in time, on an already computed
+   * geodesic, with parallel transport and when computing the
+   * MinDistance, FirstDmin or NbCrossEqPlane quantities.
+   */
+  void farFieldRadius(double r);
+  /// Get Photon::far_field_radius_
+  double farFieldRadius() const;
+
 
   // Mutators / assignment
   // ---------------------
@@ -226,12 +277,74 @@ class Gyoto::Photon
    */
   int hit(Astrobj::Properties *data=NULL);
 
+ protected:
+  /// Local variables of hit(), shared with Photon::Packet
+  struct HitState {
+    Astrobj::Properties *data; ///< Where to store the observables
+    state_t coord; ///< Current coordinates
+    double tau;    ///< Current proper time
+    double rmax;   ///< Cached object_->rMax()
+    double rr;     ///< Current distance to the centre
+    double rr_prev;///< Previous distance to the centre
+    size_t ind;    ///< Index of the last stored step
+    size_t count;  ///< Number of steps so far
+    int coordkind; ///< Cached metric_->coordKind()
+    int dir;       ///< Integration direction, 1 or -1
+    int hitt;      ///< Return value of hit()
+  };
+
+  /// First part of hit(), up to the integration loop
+  /**
+   * Check the already computed part of the geodesic and initialize
+   * the integration.
+   *
+   * \return true if there is nothing left to integrate, in which
+   * case hs.hitt is the result of hit().
+   */
+  bool hitBegin(HitState &hs, Astrobj::Properties *data);
+
+  /// Propagate the Photon analytically down to the far-field radius
+  /**
+   * Called by hitBegin() when farFieldRadius() is set. Beyond
+   * R=max(farFieldRadius(), rmax), the geodesic is approximated by a
+   * straight line in the weak field of a central mass M, estimated
+   * from g<SUB>tt</SUB> at the initial position. The Photon is moved
+   * back along this line to radius R, its date is corrected for the
+   * Shapiro delay and its 4-velocity is rebuilt so that
+   * E=-p<SUB>t</SUB> is conserved. Light bending is accounted for at
+   * first order in M/b: the direction is rotated by the deflection
+   * accumulated between R and the screen and the position is moved
+   * by the corresponding transverse offset. Terms in
+   * (M/b)<SUP>2</SUP> and the frame dragging of a spinning central
+   * object are neglected.
+   *
+   * \param rmax object_->rMax().
+   * \return false if the Photon, whose impact parameter b satisfies
+   * b-2M > rmax, cannot reach the object at all.
+   */
+  bool farField(double rmax);
+
+  /// Body of the integration loop of hit()
+  /**
+   * Process the step just made by the integrator: hs.coord and
+   * hs.tau have been updated and stopcond set accordingly.
+   *
+   * \return true if integration is finished, in which case hs.hitt
+   * is the result of hit().
+   */
+  bool hitStep(HitState &hs);
+
+ public:
   /**
    * \brief Find minimum of photon--object distance
    *
    * Return the minimum of (*object)(this->getCoord())
    * between t1 and t2. The date of this minimum is returned in tmin.
    *
+   * Uses Brent's method (golden section search and parabolic
+   * interpolation), which takes a few evaluations when the distance
+   * is smooth, to locate the minimum within #GYOTO_T_TOL.
+   *
    * \param[in] object
    *             the distance to minimize is given by
    *             object->operator()(). This method is in particular
@@ -260,11 +373,41 @@ class Gyoto::Photon
    *        value.  on output, (*object)(getCoord(toutside)) is <
    *        value, very close to value. toutside is closer to tinside
    *        on output than on input.
+   *
+   * Uses Brent's method (inverse quadratic interpolation, secant and
+   * bisection) to bracket the date within #GYOTO_T_TOL, like plain
+   * bisection would, in fewer evaluations when the distance is
+   * smooth.
    */
   void findValue(Functor::Double_constDoubleArray* object,
 		 double value,
 		 double tinside, double &toutside) ;
 
+  /// Use plain bisection in findMin() and findValue(), for testing
+  /**
+   * Brent's methods replaced plain bisection in findMin() and
+   * findValue(). The bisection is kept behind this switch so that
+   * the tests can check that both find the same dates within
+   * #GYOTO_T_TOL. It is off by default and copied along with the
+   * other integration parameters.
+   */
+  void findBisection(bool b);
+  bool findBisection() const; ///< Get #find_bisection_
+
+  /// Number of calls to findMin() and findValue() so far
+  size_t findCount() const;
+
+  /// Number of evaluations of the object in findMin() and findValue() so far
+  /**
+   * Each evaluation calls getCoord() and object->operator()().
+   */
+  size_t findEvalCount() const;
+
+ protected:
+  /// (*object)(getCoord(t)), counted in #find_evals_
+  double findEval(Functor::Double_constDoubleArray* object, double t);
+ public:
+
 #ifdef GYOTO_USE_XERCES
   virtual void setParameters(FactoryMessenger *fmp) ;
   static SmartPointer<Photon> Subcontractor(Gyoto::FactoryMessenger*);
@@ -315,12 +458,27 @@ class Gyoto::Photon
 			double const * aUnu, double const * aVnu,
 			double const * rQnu, double const * rUnu, double const * rVnu) ;
 
+  /// Get scratch memory of at least n doubles
+  /**
+   * The returned buffer belongs to the Photon and remains valid
+   * until the next call to scratch() or spectrometer(). It is meant
+   * for temporary per-step arrays in
+   * Astrobj::Generic::processHitQuantities() and the like, so that
+   * integrating inside an object does not allocate memory at each
+   * step.
+   */
+  virtual double * scratch(size_t n);
+
+  /// Number of times the scratch memory has been (re)allocated
+  size_t scratchAllocations() const;
+
  private:
   /// Allocate Photon::transmission_
   void _allocateTransmission();
 
  public:
   class Refined;
+  class Packet;
 
 };
 
@@ -351,6 +509,8 @@ class Gyoto::Photon::Refined : public Gyoto::Photon {
  public:
   Refined(Photon *parent, size_t i, int dir, double step_max);
   ///< Constructor
+  virtual ~Refined();
+  ///< Destructor, adds the findValue() statistics to *parent_
   virtual void transmit(size_t i, double t);
   ///< Update transmission both in *this and in *parent_
   virtual void transfer(double * Inu, double * Qnu, double * Unu, double * Vnu,
@@ -358,6 +518,63 @@ class Gyoto::Photon::Refined : public Gyoto::Photon {
 			double const * aUnu, double const * aVnu,
 			double const * rQnu, double const * rUnu, double const * rVnu) ;
   ///< Perform one step of radiative transfer
+  virtual double * scratch(size_t n);
+  ///< Use the scratch memory of *parent_
+};
+
+/**
+ * \class Gyoto::Photon::Packet
+ * \brief Integrate several Photons in lock-step
+ *
+ * A Packet holds up to #GYOTO_PACKET_MAX Photons: the one it is built
+ * from and clones of it. hit() integrates the geodesics of several
+ * of them at once, typically rays from adjacent pixels. The states
+ * are kept in structure-of-arrays layout and each Runge-Kutta stage
+ * is evaluated for the whole packet with a single call to
+ * Metric::Generic::diffPacket(), which analytic metrics implement as
+ * loops over the packet. Those loops are vectorized: KerrBL and KerrKS
+ * compute their Christoffel symbols, and all of them contract the
+ * symbols, #GYOTO_PACKET_LANES rays at a time in SIMD registers (see
+ * #GYOTO_PACKET_TARGETS). Packets of 8 or 16 rays are therefore the
+ * most efficient; doc/examples/benchmark-packets.C measures the gain.
+ *
+ * Each ray keeps its own adaptive step and leaves the packet as soon
+ * as its integration stops. The scheme and the step control are
+ * those of the adaptive "runge_kutta_dopri5" integrator
+ * (Dormand-Prince 5(4) with the AbsTol and RelTol of the Photon), and
+ * Metric::Generic::diffPacket() computes the same right-hand side as
+ * Metric::Generic::diff(), so that the results agree with
+ * Photon::hit() within integration tolerance. Everything else
+ * (Impact, radiative transfer, stop conditions) is done per Photon
+ * exactly as in Photon::hit().
+ *
+ * Lock-step integration therefore requires the adaptive
+ * "runge_kutta_dopri5" integrator, without parallel transport nor
+ * Hamiltonian form, see lockStep(). Otherwise, hit() calls
+ * Photon::hit() on each Photon in turn.
+ */
+class Gyoto::Photon::Packet {
+ protected:
+  Photon * photons_[GYOTO_PACKET_MAX]; ///< photons_[0] is not owned
+  size_t size_; ///< Number of Photons
+ public:
+  Packet(Photon * ph, size_t n); ///< Use ph and n-1 clones of it
+  ~Packet(); ///< Delete the clones
+  size_t size() const; ///< Number of Photons in the Packet
+  Photon * operator[](size_t k) const; ///< Photon number k
+
+  /// Integrate the geodesics of the first n Photons
+  /**
+   * Same as calling (*this)[k]->hit(data[k]) for k&lt;n.
+   */
+  void hit(Astrobj::Properties * const data[], size_t n);
+
+  /// Whether ph can be integrated in lock-step
+  static bool lockStep(Photon const * ph);
+
+ private:
+  Packet(Packet const &); ///< Not implemented
+  Packet & operator=(Packet const &); ///< Not implemented
 };
 
 
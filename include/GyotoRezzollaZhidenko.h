@@ -66,6 +66,10 @@ class Gyoto::Metric::RezzollaZhidenko
   double Nprime(const double rr) const;
   double Bprime(const double rr) const;
   int christoffel(double dst[4][4][4], const double * pos) const ;
+  /// Geodesic equation, restricted to the 9 non-zero symbols
+  int diff(state_t const &x, state_t &dxdt, double mass) const ;
+  void diffPacket(double const * x, double * dxdt, int * stop,
+		  size_t n, double mass) const ;
   int isStopCondition(double const * const coord) const;
   virtual double getRmb() const;
   virtual double getRms() const;
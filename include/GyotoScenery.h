@@ -39,6 +39,7 @@ namespace Gyoto{
 #include <GyotoScreen.h>
 #include <GyotoPhoton.h>
 #include <GyotoConverters.h>
+#include <GyotoHooks.h>
 
 #ifdef HAVE_MPI
 #include "GyotoFactory.h"
@@ -87,6 +88,46 @@ namespace Gyoto{
  * actual number of cores available on the machine usually leads to a
  * decrease in performance.
  *
+ * By default, the threads share a single cursor in the list of rays
+ * to trace and pick the next ray one at a time. With many cores and
+ * cheap rays, contention on this cursor may become noticeable. The
+ * Scheduler entity may then be set to WorkStealing: the rays are cut
+ * into tiles of TileSize consecutive rays, each thread owns a queue of
+ * tiles and steals tiles from its siblings once its own queue is
+ * empty.
+ *
+ * With PacketSize set to more than 1, each thread integrates rays
+ * from consecutive pixels PacketSize at a time, in lock-step (see
+ * Gyoto::Photon::Packet). This pays off with analytic metrics such as
+ * KerrBL, KerrKS or Minkowski, which evaluate the geodesic equation
+ * for the whole packet at once, 8 rays per SIMD loop: 8 or 16 are
+ * the best values. Packets are only used with the runge_kutta_dopri5
+ * Integrator; with any other, PacketSize is ignored.
+ *
+ * Each call to rayTrace() normally starts NThreads-1 threads and
+ * gives each thread a fresh clone of the Photon (and therefore of the
+ * Metric, Astrobj and Spectrometer). When the same Scenery is
+ * ray-traced many times on small fields, this overhead may dominate.
+ * Setting ThreadPool keeps the threads and their Photon clones alive
+ * between calls. The clones are discarded whenever the Metric, the
+ * Astrobj or the Spectrometer tell their listeners that they have
+ * changed (see Gyoto::Hook), when one of their Properties has been
+ * set (see Gyoto::Object::generation()), or when one of the Scenery's
+ * own setters is called. Mutating an Astrobj in any other way, through
+ * a method that does not tell its listeners, requires calling
+ * invalidateThreadPool() explicitly.
+ *
+ * When Gyoto is built with MPI and NProcesses is set, rayTrace()
+ * hands the rays out to worker processes in chunks of MPIChunkSize
+ * rays and keeps one chunk in flight for each worker while it
+ * computes the previous one. With MPIChunkSize left to 0, the chunks
+ * are sized from the cost per ray measured so far (see
+ * #GYOTO_MPI_CHUNK_SECONDS and #GYOTO_MPI_CHUNK_MAX).
+ * Each worker ray-traces its chunks using NThreads threads, which it
+ * keeps between chunks: a deployment may therefore run one process
+ * per node or per NUMA domain rather than one per core, saving
+ * memory and the time needed to load the Scenery in each process.
+ *
  * Finally, Scenery accepts a number of numerical tuning parameters
  * that are passed directly to the underlying photons (actually, the
  * Scenery object holds a Photon instance which stores many
@@ -115,6 +156,14 @@ namespace Gyoto{
  *
  *  <NThreads> 2 </NThreads>  
  *
+ *  How rays are distributed over the threads (Shared or WorkStealing)
+ *  and, for WorkStealing, how many rays are in each tile:
+ *  <Scheduler> WorkStealing </Scheduler>
+ *  <TileSize> 64 </TileSize>
+ *
+ *  Number of rays integrated in lock-step by each thread:
+ *  <PacketSize> 8 </PacketSize>
+ *
  *  Next come the numerical tuning parameters:
  *  Integration step, initial in case of adaptive, reset for
  *  for each ray being traced:
@@ -161,7 +210,8 @@ namespace Gyoto{
  */
 class Gyoto::Scenery
 : public Gyoto::SmartPointee,
-  public Gyoto::Object
+  public Gyoto::Object,
+  protected Gyoto::Hook::Listener
 {
   friend class Gyoto::SmartPointer<Gyoto::Scenery>;
   
@@ -206,6 +256,39 @@ class Gyoto::Scenery
 
   int nprocesses_; ///< Number of parallel processes to use in rayTrace()
 
+ public:
+  /// How rayTrace() distributes rays over threads
+  enum scheduler_t {
+    shared_cursor, ///< All threads share a single, mutex-protected cursor
+    work_stealing  ///< Per-thread queues of tiles with work stealing
+  };
+
+ protected:
+  scheduler_t scheduler_; ///< Scheduler used in rayTrace()
+
+  /// Number of rays per tile when #scheduler_ is #work_stealing
+  size_t tile_size_;
+
+  /// Number of rays integrated in lock-step, see Photon::Packet
+  size_t packet_size_;
+
+  /// Number of steps to reserve in each Photon, 0 for the default
+  size_t prealloc_;
+
+  /// Number of rays sent at once to each MPI worker, 0 for adaptive
+  size_t mpi_chunk_size_;
+
+ public:
+  /// Persistent threads and Photon clones, opaque
+  struct ThreadPool;
+
+ protected:
+  /// Whether to keep threads and Photon clones between rayTrace() calls
+  bool thread_pool_enabled_;
+
+  /// Thread pool, NULL unless #thread_pool_enabled_ and in use
+  ThreadPool * thread_pool_;
+
 # ifdef HAVE_UDUNITS
   /// See Astrobj::Properties::intensity_converter_
   Gyoto::SmartPointer<Gyoto::Units::Converter> intensity_converter_;
@@ -224,6 +307,15 @@ class Gyoto::Scenery
    * gyoto-mpi-worker executable.
    */
   boost::mpi::communicator * mpi_team_;
+
+  /// Copies of the FITS files sent to the workers, opaque
+  struct MPISnapshot;
+
+ protected:
+  /// FITS files sent to the workers by the last mpiClone(), or NULL
+  MPISnapshot * mpi_snapshot_;
+
+ public:
 # endif
   /// True in instance of gyoto-mpi-worker, otherwise false.
   static bool am_worker;
@@ -257,6 +349,14 @@ class Gyoto::Scenery
   /// Send a copy of self to the mpi workers
   /**
    * Always call mpiClone() before ray-tracing if workers are running.
+   *
+   * The Scenery itself is sent as XML. The FITS files it has read
+   * (see Gyoto::fitsOpened()) are read once by the manager and
+   * broadcast along, so that the workers load them from memory (see
+   * Gyoto::fitsMemFile()) instead of each reading the file
+   * system. With MPI-3, the workers running on the same node share a
+   * single copy of these files. The copies are released at the next
+   * call to mpiClone() or mpiTerminate().
    */
   void mpiClone();
 
@@ -407,12 +507,26 @@ class Gyoto::Scenery
   void maxCrossEqplane(double);
   /// Passed to #ph_
   double maxCrossEqplane()const;
+
+  /// Passed to #ph_, see Photon::farFieldRadius(double)
+  void farFieldRadius(double);
+  /// Passed to #ph_
+  double farFieldRadius()const;
+
+  /// Passed to #ph_, see Photon::findBisection(bool)
+  void findBisection(bool);
+  /// Passed to #ph_
+  bool findBisection()const;
   
   void secondary (bool sec) ; ///< Set ph_.secondary_
   bool secondary () const ; ///< Get ph_.secondary_
 
   void parallelTransport (bool pt) ; ///< Set ph_.parallel_transport_
   bool parallelTransport () const ; ///< Get ph_.parallel_transport_
+  void denseOutput (bool dense) ; ///< Set ph_.dense_output_
+  bool denseOutput () const ; ///< Get ph_.dense_output_
+  void hamiltonian (bool ham) ; ///< Set ph_.hamiltonian_
+  bool hamiltonian () const ; ///< Get ph_.hamiltonian_
 
   void maxiter (size_t miter) ; ///< Set ph_.maxiter_
   size_t maxiter () const ; ///< Get ph_.maxiter_
@@ -423,6 +537,57 @@ class Gyoto::Scenery
   void nProcesses(size_t); ///< Set nprocesses_;
   size_t nProcesses() const ; ///< Get nprocesses_;
 
+  /// Set #mpi_chunk_size_, 0 to size chunks from the measured cost
+  void mpiChunkSize(size_t);
+  size_t mpiChunkSize() const ; ///< Get #mpi_chunk_size_
+
+  /// Set #scheduler_ from its name: "Shared" or "WorkStealing"
+  void scheduler(std::string const &kind);
+  std::string scheduler() const ; ///< Get name of #scheduler_
+
+  void tileSize(size_t); ///< Set #tile_size_
+  size_t tileSize() const ; ///< Get #tile_size_
+
+  /// Set #packet_size_, between 1 and #GYOTO_PACKET_MAX
+  void packetSize(size_t);
+  size_t packetSize() const ; ///< Get #packet_size_
+
+  /**
+   * \brief Set #prealloc_, reserve that many steps in the Photon
+   *
+   * The Photon clones used by rayTrace() are made from the cached
+   * Photon and inherit its storage size. Reserving enough steps for
+   * the longest rays saves reallocating during integration. Storage
+   * is never shrunk. rayTrace() also grows the cached Photon to the
+   * largest size used by its clones, so that the next ray-tracing
+   * does not reallocate.
+   */
+  void preallocateSteps(size_t);
+  size_t preallocateSteps() const ; ///< Get #prealloc_
+
+  /// Set #thread_pool_enabled_, stop the threads if false
+  void threadPool(bool);
+  bool threadPool() const ; ///< Get #thread_pool_enabled_
+
+  /// Discard the Photon clones held by the thread pool
+  /**
+   * They will be re-cloned from the cached Photon at the next call
+   * to rayTrace(). This is done automatically when a Metric, Astrobj
+   * or Spectrometer tells its listeners that it has changed.
+   */
+  void invalidateThreadPool();
+
+ protected:
+  /// Invalidate the thread pool when the Metric, Astrobj or Spectrometer mutate
+  virtual void tell(Gyoto::Hook::Teller *msg);
+
+#ifdef HAVE_PTHREAD
+  /// Start #thread_pool_ if needed and make sure its Photon clones are current
+  void prepareThreadPool();
+#endif
+
+ public:
+
   /// Set Scenery::intensity_converter_
   void intensityConverter(std::string unit);
   /// Set Scenery::spectrum_converter_
@@ -458,7 +623,9 @@ class Gyoto::Scenery
    *
    * If MPI support is built-in, MPI_Init() has been called, and
    * nprocesses_ is &ge;1, then rayTrace() will use several processes,
-   * launching them using mpiSpawn() if necessary.
+   * launching them using mpiSpawn() if necessary. Each worker process
+   * in turn ray-traces the chunks of rays it receives using
+   * Scenery::nthreads_ threads, as below.
    *
    * Else, if Scenery::nthreads_ is &ge;2 and Gyoto has been compiled with
    * pthreads support, rayTrace() will use Scenery::nthreads_ threads
@@ -498,6 +665,24 @@ class Gyoto::Scenery
 		Astrobj::Properties *data,
 		double * impactcoords=NULL);
 
+ protected:
+  /// Perform ray-tracing in this process
+  /**
+   * Same as rayTrace(), using the local threads only. This is what
+   * rayTrace() does when there is no MPI team. MPI workers call it on
+   * each chunk of rays they receive from the manager.
+   */
+  void rayTraceLocal(
+#ifdef GYOTO_SWIGIMPORTED
+		     Coord2dSet & ij,
+#else
+		     Screen::Coord2dSet & ij,
+#endif
+		     Astrobj::Properties *data,
+		     double * impactcoords);
+
+ public:
+
   /// Ray-trace a single pixel in Scenery::screen_
   /**
    * Almost identical to rayTrace(), but for a single pixel.
@@ -520,6 +705,24 @@ class Gyoto::Scenery
   void operator() (double alpha, double delta, Astrobj::Properties *data,
 		   Photon * ph = NULL);
 
+  /// Everything operator()() does but the integration itself
+  /**
+   * Initialize data and ph for pixel (i, j).
+   *
+   * \return true if ph->hit(data) remains to be called.
+   */
+  bool prepareRay(size_t i, size_t j, Astrobj::Properties *data,
+		  double * impactcoords, Photon * ph);
+
+  /// Everything operator()() does but the integration itself
+  /**
+   * Initialize data and ph for direction (alpha, delta).
+   *
+   * \return true if ph->hit(data) remains to be called.
+   */
+  bool prepareRay(double alpha, double delta, Astrobj::Properties *data,
+		  Photon * ph);
+
 #ifdef GYOTO_USE_XERCES
  public:
   // Override fillProperty() to issue InitCoord only if it was set
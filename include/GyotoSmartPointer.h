@@ -13,6 +13,8 @@
   SmartPointer<Gyoto::Metric::Generic> ObjPtr (new Gyoto::Metric(...));
   @endcode
 
+  Template class Gyoto::SharedArray<T> uses the same mechanism to let
+  clones share large, read-only arrays.
 
  */
 
@@ -40,14 +42,13 @@
 #define __GyotoSmartPointer_H_
 
 #include "GyotoUtils.h"
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-#endif
+#include <atomic>
 
 namespace Gyoto {
   class SmartPointee;
   class FactoryMessenger;
   template <class T> class SmartPointer;
+  template <class T> class SharedArray;
 }
 
 #include <GyotoError.h>
@@ -56,6 +57,7 @@ namespace Gyoto {
 #include <typeinfo>
 #include <string>
 #include <vector>
+#include <algorithm>
 
 /**
  * \brief Can be pointed to by a SmartPointer
@@ -80,19 +82,20 @@ namespace Gyoto {
 class Gyoto::SmartPointee
 {
  private:
-  int refCount; ///< Reference counter.
-
-# ifdef HAVE_PTHREAD
   /**
-   * When compiled with libpthread
+   * \brief Reference counter
+   *
+   * Atomic so that SmartPointers to the same object may be copied
+   * and destroyed concurrently by several threads without locking.
    */
-  pthread_mutex_t mutex_; ///< A mutex
-#endif
+  std::atomic<int> refCount;
 
  public:
   SmartPointee () ;
   virtual ~SmartPointee() ;
   SmartPointee (const   SmartPointee&) ; ///< Copy constructor
+  /// Assignment, leaves the reference counter alone
+  SmartPointee & operator=(const SmartPointee&) ;
   void incRefCount () ; ///< Increment the reference counter. Warning: Don't mess with the counter.
   int decRefCount () ;  ///< Decrement the reference counter and return current value. Warning: Don't mess with the counter.
   int getRefCount () ;  ///< Get the current number of references
@@ -352,4 +355,109 @@ class Gyoto::SmartPointer
 
 };
 
+/**
+ * \brief Reference-counted, copy-on-write array
+ *
+ * Copying a SharedArray does not copy the data: both copies refer to
+ * the same storage, which is freed with the last of them. This lets
+ * the clones of an object (e.g. one per thread in
+ * Scenery::rayTrace()) share large grids. The data are read through
+ * get(); write() first copies them if they are shared.
+ *
+ * A SharedArray may also borrow() an array it does not own, in which
+ * case the owner must keep it alive for as long as the SharedArray
+ * or any copy of it uses it.
+ */
+template <class T>
+class Gyoto::SharedArray
+{
+ public:
+  /**
+   * \brief Storage, deleted with the last SharedArray pointing to it
+   *
+   * The default Block allocates its data with new []. Derived
+   * classes may provide other storage (e.g. a memory-mapped file,
+   * see Gyoto::fitsMapImage()): they set #data in their constructor
+   * and release it, then reset #data to NULL, in their destructor.
+   */
+  class Block : public Gyoto::SmartPointee {
+  public:
+    T * data;
+    explicit Block(size_t n) : SmartPointee(), data(new T[n]) {}
+    virtual ~Block() { delete [] data; }
+  protected:
+    Block() : SmartPointee(), data(NULL) {}
+  };
+
+ private:
+  SmartPointer<Block> block_; ///< Owner of #data_, NULL if borrowed
+  T * data_; ///< First element, NULL if empty
+  size_t size_; ///< Number of elements
+
+ public:
+  SharedArray() : block_(NULL), data_(NULL), size_(0) {}
+
+  /// Take ownership of b, which holds n elements
+  SharedArray(Block * b, size_t n)
+    : block_(b), data_(b ? b->data : NULL), size_(data_ ? n : 0) {}
+
+  /// Copy n elements from src
+  SharedArray(T const * src, size_t n)
+    : block_(NULL), data_(NULL), size_(0)
+  { if (src && n) std::copy(src, src+n, allocate(n)); }
+
+  SharedArray(SharedArray<T> const &o)
+    : block_(o.block_), data_(o.data_), size_(o.size_) {}
+
+  SharedArray<T> & operator=(SharedArray<T> const &o) {
+    block_ = static_cast<Block*>(o.block_);
+    data_  = o.data_;
+    size_  = o.size_;
+    return *this;
+  }
+
+  /// Read-only access to the data
+  T const * get() const { return data_; }
+  operator T const * () const { return data_; }
+  size_t size() const { return size_; }
+
+  /// Whether other SharedArrays use the same data
+  bool shared() const
+  { return data_ && (!block_ || block_->getRefCount() > 1); }
+
+  /**
+   * \brief Writable access to the data
+   *
+   * The data are first copied if they are shared() with another
+   * SharedArray or borrowed, so that writing never affects the
+   * copies.
+   */
+  T * write() {
+    if (shared()) {
+      T const * old = data_;
+      SmartPointer<Block> keep = block_;
+      std::copy(old, old+size_, allocate(size_));
+    }
+    return data_;
+  }
+
+  /// Replace the data with n new, uninitialized elements
+  T * allocate(size_t n) {
+    block_ = new Block(n);
+    data_  = block_->data;
+    size_  = n;
+    return data_;
+  }
+
+  /// Use n elements at src, which remain owned by the caller
+  void borrow(T const * src, size_t n) {
+    block_ = NULL;
+    data_  = const_cast<T*>(src);
+    size_  = src ? n : 0;
+  }
+
+  /// Forget the data, freeing them if not used elsewhere
+  void reset() { block_ = NULL; data_ = NULL; size_ = 0; }
+};
+
 #endif
@@ -38,6 +38,9 @@ namespace Gyoto{
 
 #include <GyotoStar.h>
 
+#include <vector>
+#include <array>
+
 /**
  * \class Gyoto::Astrobj::StarTrace
  * \brief Like a Star that would be on all points of its orbit at all time
@@ -65,6 +68,11 @@ namespace Gyoto{
  * </Astrobj>
  * \endcode
  *
+ * operator()() finds the sample of the trace nearest to a given point
+ * using a bounding volume hierarchy over the samples dated between
+ * tmin_ and tmax_. This hierarchy is built on first use and rebuilt
+ * only when the trace or the time window changes.
+ *
  */
 class Gyoto::Astrobj::StarTrace :
   public Gyoto::Astrobj::Star {
@@ -79,6 +87,27 @@ class Gyoto::Astrobj::StarTrace :
   double * y_; ///< Cartesian y
   double * z_; ///< Cartesian z
 
+  /// Node of the bounding volume hierarchy
+  struct BVHNode {
+    double lo[3]; ///< Lower corner of the box containing the samples
+    double hi[3]; ///< Upper corner of the box containing the samples
+    size_t begin; ///< First sample of the node in #bvh_points_
+    size_t end; ///< One past last sample of the node in #bvh_points_
+    /// Index of the second child in #bvh_, 0 for a leaf
+    /**
+     * The first child always immediately follows its parent.
+     */
+    size_t right;
+  };
+
+  /// Bounding volume hierarchy over the samples, root first
+  std::vector<BVHNode> bvh_;
+  /// Cartesian coordinates of the samples, in #bvh_ order
+  std::vector<std::array<double, 3> > bvh_points_;
+  bool bvh_valid_; ///< False when #bvh_ must be rebuilt
+  size_t bvh_imin_; ///< #imin_ when #bvh_ was built
+  size_t bvh_imax_; ///< #imax_ when #bvh_ was built
+
   // Constructors - Destructor
   // -------------------------
  public:
@@ -122,6 +151,14 @@ class Gyoto::Astrobj::StarTrace :
   void computeXYZ(size_t i); ///< Compute (and cache) x_, y_ and z_ for one date
   void computeXYZ(); ///< Compute (and cache) x_, y_ and z_
 
+ protected:
+  /// Build #bvh_ over the samples between tmin_ and tmax_
+  void buildBVH();
+  /// Build the subtree of #bvh_ for samples begin to end of #bvh_points_
+  void buildBVH(size_t begin, size_t end);
+
+ public:
+
   using Star::setInitCoord;
   virtual void setInitCoord(const double coord[8], int dir = 0);
 
@@ -144,8 +181,15 @@ class Gyoto::Astrobj::StarTrace :
   using Star::setInitialCondition;
   virtual void setInitialCondition(double const coord[8]); ///< Same as Worldline::setInitialCondition(gg, coord, sys,1)
 
+  /// Square of the distance to the nearest sample of the trace
+  /**
+   * Only the samples dated between tmin_ and tmax_ are considered.
+   */
   virtual double operator()(double const coord[4]) ;
 
+  /// Ball containing the whole trace, whatever the dates
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
+
 };
 
 
@@ -129,6 +129,14 @@ class Gyoto::Astrobj::ThinDisk :
    */
   virtual double operator()(double const coord[]) ; ///< theta-pi/2 or z
 
+  /// Equatorial plane up to rout_
+  /**
+   * This assumes that the disk is where operator() changes sign:
+   * subclasses that reimplement operator() must reimplement this
+   * too.
+   */
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
+
   virtual double projectedRadius(double const coord[]) const ;
       ///< Projected radius of position coord on the equatorial plane
 
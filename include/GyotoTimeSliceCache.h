@@ -0,0 +1,157 @@
+/**
+ * \file GyotoTimeSliceCache.h
+ * \brief Bounded cache of time slices
+ *
+ *  Used by the Astrobj kinds that are described by one set of
+ *  arrays per date, such as DynamicalDisk and DynamicalDisk3D.
+ */
+
+/*
+  Copyright 2026 Frederic Vincent, Thibaut Paumard
+
+  This file is part of Gyoto.
+
+  Gyoto is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  Gyoto is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with Gyoto.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __GyotoTimeSliceCache_H_
+#define __GyotoTimeSliceCache_H_
+
+#include "GyotoConfig.h"
+#include "GyotoSmartPointer.h"
+
+#include <vector>
+#include <functional>
+#include <atomic>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+namespace Gyoto {
+  class TimeSliceCache;
+}
+
+/**
+ * \class Gyoto::TimeSliceCache
+ * \brief Bounded LRU cache of time slices, loaded on demand
+ *
+ * A time slice is a set of arrays (e.g. emission, velocity and
+ * radius) describing an object at one date. Rather than reading all
+ * the slices upfront, the object get()s them from a TimeSliceCache,
+ * which reads them when first needed through a Loader and keeps the
+ * most recently used ones within a memory budget.
+ *
+ * Evicting a slice only drops the reference held by the cache: the
+ * slices returned by get() remain valid for as long as the caller
+ * keeps them.
+ *
+ * When a slice is requested, its neighbours are read ahead in a
+ * background thread (if Gyoto was built with pthreads and
+ * prefetching is on). A TimeSliceCache is thread-safe and is meant
+ * to be shared by the clones of an object. The Loader may therefore
+ * run in several threads at once; if it uses cfitsio, it should hold
+ * Gyoto::fitsLock().
+ *
+ * Getting a resident slice only takes a shared lock, so that threads
+ * do not wait for each other while no slice is being read or
+ * evicted. Recency is then recorded as a stamp in the entry rather
+ * than by reordering a list.
+ */
+class Gyoto::TimeSliceCache : public Gyoto::SmartPointee
+{
+ public:
+  /// The arrays describing one date
+  typedef std::vector<SharedArray<double> > Slice;
+
+  /// Read slice i (from 0) into slice
+  /**
+   * May be called from a background thread: it must not use the
+   * object that owns the cache, which may be in use or even
+   * destroyed by then.
+   */
+  typedef std::function<void(size_t i, Slice &slice)> Loader;
+
+ private:
+  /// One cache entry
+  struct Entry {
+    Slice slice; ///< The arrays, empty if not resident
+    bool loading; ///< True while the Loader is reading this slice
+    std::atomic<size_t> stamp; ///< Value of #clock_ when last used
+    Entry() : slice(), loading(false), stamp(0) {}
+  };
+
+  Loader loader_; ///< Reads the slices
+  std::vector<Entry> entries_; ///< One entry per slice
+  size_t budget_; ///< Maximum resident size in bytes, 0 for unlimited
+  size_t inflight_; ///< Number of background reads in progress
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t mutex_; ///< Protects all of the above
+  pthread_cond_t loaded_; ///< Signaled each time a read ends
+  /// Protects the slices of #entries_
+  /**
+   * Held shared to copy a slice, exclusive (with #mutex_ also held)
+   * to change one. Holding #mutex_ alone is therefore enough to read
+   * the slices.
+   */
+  pthread_rwlock_t slices_;
+#endif
+  // Updated under #mutex_, but read without it by the accessors
+  std::atomic<size_t> resident_; ///< Current resident size in bytes
+  std::atomic<bool> prefetch_; ///< Whether to read neighbours in the background
+  std::atomic<size_t> clock_; ///< Number of slices used or read so far
+  std::atomic<size_t> misses_; ///< Number of get() calls that had to read the slice
+  std::atomic<size_t> prefetched_; ///< Number of slices read in the background
+
+ public:
+  /// Cache of nslices slices read by loader
+  TimeSliceCache(size_t nslices, Loader loader);
+  virtual ~TimeSliceCache();
+
+  /// Get slice i (from 0), reading it if needed
+  /**
+   * The arrays of the returned Slice are shared with the cache, not
+   * copied, and remain valid after the slice is evicted.
+   */
+  Slice get(size_t i);
+
+  /// Read slice i in the background if not resident
+  void readAhead(size_t i);
+
+  size_t size() const; ///< Number of slices
+  void budget(size_t bytes); ///< Set memory budget, 0 for unlimited
+  size_t budget() const; ///< Get memory budget
+  void prefetch(bool p); ///< Turn background reads on or off
+  bool prefetch() const; ///< Whether background reads are on
+  size_t resident() const; ///< Memory used by resident slices, in bytes
+  size_t hits() const; ///< Number of get() calls served from memory
+  size_t misses() const; ///< Number of get() calls that read the slice
+  size_t prefetched() const; ///< Number of slices read in the background
+
+ private:
+  TimeSliceCache(TimeSliceCache const &); ///< Not copyable
+  /// Read slice i, marked as loading, and make it resident
+  /**
+   * #mutex_ is held on entry and on exit, but not while reading.
+   */
+  void read(size_t i);
+  /// Drop least recently used slices to fit in #budget_
+  /**
+   * #mutex_ and #slices_ (exclusive) are held.
+   */
+  void evict();
+  /// Worker for readAhead()
+  static void * prefetchWorker(void *arg);
+};
+
+#endif
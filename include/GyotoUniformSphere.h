@@ -170,6 +170,9 @@ class Gyoto::Astrobj::UniformSphere :
    */
   virtual double deltaMax(double*coord);
 
+  /// Ball containing the sphere at both dates
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
+
  protected:
   /**
    * If the coordinate system of the Metric object is spherical, use a
@@ -64,6 +64,25 @@ namespace Gyoto {
    * See verbose(int mode).
    */
   int verbose();
+
+  /// Set FITS mapping mode
+  /**
+   * When on, the FITS readers that support it (PatternDisk, Disk3D,
+   * FlaredDiskSynchrotron, XillverReflection...) map uncompressed,
+   * double-precision image HDUs into memory with fitsMapImage()
+   * instead of reading them. Loading is then nearly instant and the
+   * system only pages in the parts of the tables that are actually
+   * used. Off by default.
+   *
+   * \param mode 1 to turn on FITS mapping, 0 to turn it off.
+   */
+  void fitsMap(int mode);
+
+  /// Get FITS mapping mode
+  /**
+   * See fitsMap(int mode).
+   */
+  int fitsMap();
   
   /// Convert lengths (deprecated)
   /**
@@ -61,6 +61,10 @@ namespace Gyoto {
 			"Whether to stop Photon integration at 180° deflection.") \
     GYOTO_PROPERTY_BOOL(c, ParallelTransport, NoParallelTransport, _parallelTransport,	\
 			"Whether to perform parallel transport of a local triad (used for polarization).") \
+    GYOTO_PROPERTY_BOOL(c, DenseOutput, RefineOutput, _denseOutput,	\
+			"Whether to interpolate between integration steps (else re-integrate).") \
+    GYOTO_PROPERTY_BOOL(c, Hamiltonian, Lagrangian, _hamiltonian,	\
+			"Whether to integrate the covariant momentum rather than the 4-velocity (Boost integrators).") \
     GYOTO_PROPERTY_DOUBLE(c, MaxCrossEqplane, _maxCrossEqplane,	\
 			  "Maximum number of crossings of the equatorial plane allowed for this worldline") \
     GYOTO_PROPERTY_DOUBLE(c, RelTol, _relTol,				\
@@ -106,6 +110,10 @@ namespace Gyoto {
   bool c::_secondary() const {return secondary();}			\
   void c::_parallelTransport(bool s) {parallelTransport(s);}		\
   bool c::_parallelTransport() const {return parallelTransport();}	\
+  void c::_denseOutput(bool s) {denseOutput(s);}			\
+  bool c::_denseOutput() const {return denseOutput();}			\
+  void c::_hamiltonian(bool s) {hamiltonian(s);}			\
+  bool c::_hamiltonian() const {return hamiltonian();}			\
   void c::_adaptive(bool s) {adaptive(s);}				\
   bool c::_adaptive() const {return adaptive();}			\
   void c::_maxCrossEqplane(double max){maxCrossEqplane(max);}	      	\
@@ -172,6 +180,10 @@ namespace Gyoto {
   bool _secondary () const ;				\
   void _parallelTransport (bool sec) ;			\
   bool _parallelTransport () const ;			\
+  void _denseOutput (bool dense) ;			\
+  bool _denseOutput () const ;				\
+  void _hamiltonian (bool ham) ;			\
+  bool _hamiltonian () const ;				\
   void _maxiter (size_t miter) ;			\
   size_t _maxiter () const ;				\
   void _integrator(std::string const & type);		\
@@ -205,9 +217,12 @@ namespace Gyoto {
  * derive from IntegState::Generic.
  *
  * The coordinates of the Worldline are stored in #x0_, #x1_, #x2_,
- * #x3_, #x0dot_, #x1dot_, #x2dot_ ans #x3dot_. Those arrays are
- * extended as needed using xExpand(). These coordinates can be
- * retrieved using get_t(), get_xyz(), getCartesian(), getCoord() etc.
+ * #x3_, #x0dot_, #x1dot_, #x2dot_ ans #x3dot_. Those are strided
+ * views (Worldline::Column) in a single array of fixed-size records
+ * (#xrec_), one per integration step, so that storing or reading a
+ * step touches contiguous memory. This array is extended as needed
+ * using xExpand(). These coordinates can be retrieved using get_t(),
+ * get_xyz(), getCartesian(), getCoord() etc.
  *
  * Worldline does not derive from Object, and does not instantiate a
  * Property list. This is because this would lead to multiple
@@ -239,25 +254,58 @@ class Gyoto::Worldline
   int stopcond; ///< Whether and why integration is finished
 
  protected:
+  /**
+   * \brief One field of the trajectory records
+   *
+   * Strided view in #xrec_ which can be indexed like a plain array
+   * of x_size_ elements. It becomes invalid when #xrec_ is
+   * reallocated, which only happens in xAllocate(), xExpand(),
+   * eAllocate() and eDeallocate().
+   */
+  class Column {
+    double * base_; ///< Address of element 0
+    size_t stride_; ///< Distance between consecutive elements
+  public:
+    Column() : base_(NULL), stride_(0) {}
+    Column(double * base, size_t stride) : base_(base), stride_(stride) {}
+    double & operator[](size_t i) const { return base_[i*stride_]; }
+    bool operator==(Column const &o) const { return base_==o.base_; }
+    /// Copy n elements starting at first into contiguous array dest
+    void get(double * dest, size_t first, size_t n) const {
+      double const * src=base_+first*stride_;
+      for (size_t i=0; i<n; ++i, src+=stride_) dest[i]=*src;
+    }
+  };
+
   SmartPointer<Gyoto::Metric::Generic> metric_ ; ///< The Gyoto::Metric in this part of the universe
-  double* tau_; ///< proper time or affine parameter
-  double* x0_;///< t or T
-  double* x1_;///< r or x
-  double* x2_;///< &theta; or y
-  double* x3_;///< &phi; or z
-  double* x0dot_;///< tdot or Tdot
-  double* x1dot_;///< rdot or xdot
-  double* x2dot_;///< &theta;dot or ydot
-  double* x3dot_;///< &phi;dot or zdot
-  double* ep0_;/// Coordinate of first base vector to parallel transport
-  double* ep1_;/// Coordinate of first base vector to parallel transport
-  double* ep2_;/// Coordinate of first base vector to parallel transport
-  double* ep3_;/// Coordinate of first base vector to parallel transport
-  double* et0_;/// Coordinate of Second base vector to parallel transport
-  double* et1_;/// Coordinate of Second base vector to parallel transport
-  double* et2_;/// Coordinate of Second base vector to parallel transport
-  double* et3_;/// Coordinate of Second base vector to parallel transport
-  size_t x_size_;///< Size of #x0_, #x1_... arrays
+  /**
+   * \brief Trajectory storage
+   *
+   * #x_size_ records of #xstride_ doubles: &tau;, x<SUP>&mu;</SUP>,
+   * dx<SUP>&mu;</SUP>/d&tau; and, if #parallel_transport_, the
+   * components of the two transported vectors.
+   */
+  double * xrec_;
+  size_t xstride_; ///< Number of doubles per record in #xrec_
+  Column tau_; ///< proper time or affine parameter
+  Column x0_;///< t or T
+  Column x1_;///< r or x
+  Column x2_;///< &theta; or y
+  Column x3_;///< &phi; or z
+  Column x0dot_;///< tdot or Tdot
+  Column x1dot_;///< rdot or xdot
+  Column x2dot_;///< &theta;dot or ydot
+  Column x3dot_;///< &phi;dot or zdot
+  Column ep0_;/// Coordinate of first base vector to parallel transport
+  Column ep1_;/// Coordinate of first base vector to parallel transport
+  Column ep2_;/// Coordinate of first base vector to parallel transport
+  Column ep3_;/// Coordinate of first base vector to parallel transport
+  Column et0_;/// Coordinate of Second base vector to parallel transport
+  Column et1_;/// Coordinate of Second base vector to parallel transport
+  Column et2_;/// Coordinate of Second base vector to parallel transport
+  Column et3_;/// Coordinate of Second base vector to parallel transport
+  size_t x_size_;///< Number of records in #xrec_
+  size_t xexpand_count_;///< Number of calls to xExpand(int) so far
   size_t imin_;///< Minimum index for which #x0_, #x1_... have been computed
   size_t i0_;  ///< Index of initial condition in array
   size_t imax_;///< Maximum index for which #x0_, #x1_... have been computed
@@ -278,6 +326,40 @@ class Gyoto::Worldline
    */
   bool parallel_transport_;
 
+  /**
+   * \brief Whether getCoord() interpolates between steps
+   *
+   * If true, getCoord(double const * const dates, ...) evaluates the
+   * dense output of the integrator between the two bracketing steps
+   * (see denseCoord()). Else (the default), it integrates again from
+   * both bracketing steps using IntegState::Generic::doStep(), which
+   * is slower. Ignored when the integrator is exact
+   * (IntegState::Generic::exact()).
+   */
+  bool dense_output_;
+
+  /**
+   * \brief Whether to integrate the Hamiltonian form of the geodesic equation
+   *
+   * If true, the Boost integrators evolve the covariant momentum
+   * p<SUB>&mu;</SUB> using Metric::Generic::diffHamiltonian() instead
+   * of the 4-velocity. The conversion happens within
+   * IntegState::Boost, so that the coordinates stored in the
+   * Worldline remain x<SUP>&mu;</SUP> and dx<SUP>&mu;</SUP>/d&lambda;
+   * in either case. Ignored by the other integrators and when
+   * #parallel_transport_ is true.
+   */
+  bool hamiltonian_;
+
+  /// \brief Lower state of the last interval used by denseCoord()
+  state_t dense_yl_;
+  /// \brief Upper state of the last interval used by denseCoord()
+  state_t dense_yh_;
+  /// \brief Derivative of #dense_yl_ w.r.t. the integration parameter
+  state_t dense_fl_;
+  /// \brief Derivative of #dense_yh_ w.r.t. the integration parameter
+  state_t dense_fh_;
+
   /**
    * \brief Initial integrating step
    *
@@ -455,7 +537,14 @@ class Gyoto::Worldline
   virtual void setPosition(double const pos[4]); ///< Set initial 4-position
   virtual void setVelocity(double const vel[3]); ///< Set initial 3-velocity
 
-  void reset() ; ///< Forget integration, keeping initial contition
+  /**
+   * \brief Forget integration, keeping initial contition
+   *
+   * The storage (#xrec_) is kept at its current size, so that a
+   * Worldline which is reset and integrated again only reallocates
+   * if the new integration is longer than all previous ones.
+   */
+  void reset() ;
   void reInit() ; ///< Reset and recompute particle properties
 
   virtual std::string className() const ; ///< "Worldline"
@@ -466,7 +555,9 @@ class Gyoto::Worldline
    *
    * Initialize #state_ to use the required integrator.
    *
-   * \param[in] type Either "Legacy" or (if GYOTO_HAVE_BOOST_INTEGRATORS) one of
+   * \param[in] type Either "Legacy", "KerrAnalytic" (see
+   *                 IntegState::KerrAnalytic) or (if
+   *                 GYOTO_HAVE_BOOST_INTEGRATORS) one of
    *                 "runge_kutta_cash_karp54",
    *                 "runge_kutta_fehlberg78", "runge_kutta_dopri5",
    *                 "runge_kutta_cash_karp54_classic"
@@ -524,6 +615,18 @@ class Gyoto::Worldline
 
   // Memory management
   // ----------------- 
+  /**
+   * \brief Make room for at least n records
+   *
+   * Computed records are kept. The storage is grown in the direction
+   * in which integration proceeds from #i0_. Nothing is done if
+   * there is already room for n records: storage never shrinks.
+   * Growing this way is not counted in xExpandCount().
+   */
+  void xReserve(size_t n);
+  size_t xCapacity() const; ///< Get #x_size_
+  size_t xExpandCount() const; ///< Get #xexpand_count_
+
  protected:
   /**
    * The default size is #GYOTO_DEFAULT_X_SIZE
@@ -548,6 +651,19 @@ class Gyoto::Worldline
    */
   virtual size_t xExpand(int dir); ///< Expand x0, x1 etc... to hold more elements
 
+  /**
+   * \brief Point #tau_, #x0_... at their fields in #xrec_
+   */
+  void xBind();
+
+  /**
+   * \brief Change the number of doubles per record
+   *
+   * Copy the computed records (between #imin_ and #imax_) to a new
+   * #xrec_ with stride #xstride_=stride.
+   */
+  void xRestride(size_t stride);
+
   /**
    * If you need to expand more arrays than x0_ ... x3_ and the dots,
    * call this on your array before calling xExpand(int dir).
@@ -558,17 +674,20 @@ class Gyoto::Worldline
   virtual void xExpand(double * &x, int dir); ///< Expand one array to hold more elements
 
   /**
-   * Allocate memory for polarization vectors
+   * Allocate memory for polarization vectors, i.e. widen the records
+   * in #xrec_
    */
   virtual void eAllocate (); ///< Allocate ep0_ ... et3_.
 
   /**
-   * Deallocate memory for polarization vectors
+   * Deallocate memory for polarization vectors, i.e. narrow the
+   * records in #xrec_
    */
   virtual void eDeallocate (); ///< Deallocate ep0_ ... et3_.
 
   /**
-   * Call #xExpand(double * &x, int dir) on #ep0_, #ep1_ etc.
+   * Does nothing: the polarization vectors are expanded with the
+   * rest of the records by xExpand(int dir).
    */
   virtual void eExpand(int dir); /// Expand memory slots for polarization vectors
 
@@ -590,6 +709,10 @@ class Gyoto::Worldline
   bool secondary () const ; ///< Get #secondary_
   void parallelTransport (bool pt) ; ///< Set #parallel_transport_
   bool parallelTransport () const ; ///< Get #parallel_transport_
+  void denseOutput (bool dense) ; ///< Set #dense_output_
+  bool denseOutput () const ; ///< Get #dense_output_
+  void hamiltonian (bool ham) ; ///< Set #hamiltonian_
+  bool hamiltonian () const ; ///< Get #hamiltonian_
   void maxiter (size_t miter) ; ///< Set #maxiter_
   size_t maxiter () const ; ///< Get #maxiter_
 
@@ -640,7 +763,7 @@ class Gyoto::Worldline
    * #parallel_transport_, get position (xi_), velocity (xidot_) and
    * possibly other triad vectors (epi_ and eti_).
    */
-  void getInitialCoord(std::vector<double> &dest) const; ///< Get initial coordinates + base vectors
+  void getInitialCoord(state_t &dest) const; ///< Get initial coordinates + base vectors
 
   /**
    * Depending on the value of #parallel_transport_, get position
@@ -757,6 +880,36 @@ class Gyoto::Worldline
 		double * et0=NULL, double * et1=NULL, double * et2=NULL, double * et3=NULL,
 		double * otime=NULL, bool proper=false) ;
 
+ protected:
+  /**
+   * \brief Dense output between two consecutive steps
+   *
+   * Evaluate the dense output of the integrator between the stored
+   * states at indices il and ih=il+1 (see
+   * IntegState::Generic::denseStep()). If the integrator has none,
+   * evaluate instead the cubic Hermite polynomial which matches
+   * both states and their derivatives with respect to the
+   * integration parameter. Those derivatives are computed with
+   * Metric::Generic::diff() and cached for the last interval. In
+   * either case, repeated calls in the same interval (as in
+   * Photon::findValue()) cost a few polynomial evaluations.
+   *
+   * \param[in] il, ih indices of the bracketing steps;
+   * \param[in] date coordinate time, or integration parameter if
+   *               proper;
+   * \param[in] proper whether date is the integration parameter;
+   * \param[out] res interpolated state, sized like in getCoord(size_t
+   *               index, state_t &coord) const;
+   * \param[out] tau interpolated integration parameter.
+   * \return false if dense output is not possible (e.g. with
+   *               IntegState::Legacy, which does not record the
+   *               integration parameter), in which case the caller
+   *               should fall back to re-integration.
+   */
+  bool denseCoord(size_t il, size_t ih, double date, bool proper,
+		  state_t &res, double &tau);
+ public:
+
   /**
    * \brief Get all computed positions
    *
@@ -805,6 +958,7 @@ class Gyoto::Worldline
   public:
     class Generic;
     class Legacy;
+    class KerrAnalytic;
 #ifdef GYOTO_HAVE_BOOST_INTEGRATORS
     class Boost;
 #endif
@@ -924,6 +1078,32 @@ class Gyoto::Worldline::IntegState::Generic : public SmartPointee {
                       double step,
 		      double coordout[8]) = delete;
 
+  /// Whether doStep() is exact
+  /**
+   * If true, doStep() propagates the state exactly whatever the
+   * step, so that Worldline::getCoord() refines between samples with
+   * doStep() instead of interpolating. Default: false.
+   */
+  virtual bool exact() const;
+
+  /// Dense output of the integrator within one step
+  /**
+   * Evaluate the continuous extension of the integration scheme
+   * over the step of size step starting at coordin, at fraction frac
+   * of this step. Consecutive calls with the same coordin and step
+   * do not integrate again.
+   *
+   * \param[in] coordin position-velocity at the beginning of the step;
+   * \param[in] step size of the step;
+   * \param[in] frac fraction of the step, in [0, 1];
+   * \param[out] coordout interpolated position-velocity, sized like
+   *             coordin.
+   * \return false if this integrator has no dense output (the
+   *             default).
+   */
+  virtual bool denseStep(state_t const &coordin, double step, double frac,
+			 state_t &coordout);
+
 };
 
 /**
@@ -963,6 +1143,107 @@ class Gyoto::Worldline::IntegState::Legacy : public Generic {
   virtual ~Legacy();
 };
 
+/**
+ * \class Gyoto::Worldline::IntegState::KerrAnalytic
+ * \brief Semi-analytic integrator for geodesics of the Kerr metric
+ *
+ * In Mino time &lambda; (d&tau;=&Sigma;d&lambda;), the radial and
+ * polar motions along a Kerr geodesic decouple:
+ * (dr/d&lambda;)<SUP>2</SUP>=R(r) and
+ * (du/d&lambda;)<SUP>2</SUP>=U(u), u=cos&theta;, where R and U are
+ * quartic polynomials whose coefficients depend on the energy E, the
+ * angular momentum L and the Carter constant Q. Both equations are
+ * solved in closed form with the Weierstrass elliptic function
+ * &weierp; (Biermann-Weierstrass formula), whatever the root
+ * configuration of the potential: there is no step-size control and
+ * no drift of the constants of motion. t, &phi; and &tau;, whose
+ * derivatives are sums of a function of r and a function of u, are
+ * obtained by Gauss-Legendre quadrature over each step.
+ *
+ * The step size only sets the sampling of the Worldline: it is the
+ * step given by Worldline::deltaMax(), or Worldline::delta() if the
+ * Worldline is not adaptive. In addition, steps end just after each
+ * crossing of the equatorial plane, so that thin disks are hit
+ * between two samples that bracket the plane tightly, and do not
+ * cross the event horizon.
+ *
+ * To use this integrator, pass "KerrAnalytic" to
+ * Worldline::integrator(std::string type). The Metric must be a
+ * KerrBL. Parallel transport is not supported.
+ */
+class Gyoto::Worldline::IntegState::KerrAnalytic : public Generic {
+  friend class Gyoto::SmartPointer<Gyoto::Worldline::IntegState::KerrAnalytic>;
+
+ public:
+  /// Quartic potential f and solution of (dx/d&lambda;)<SUP>2</SUP>=f(x)
+  struct Potential {
+    double c[5]; ///< f(x)=c[4]x<SUP>4</SUP>+...+c[0]
+    double g2; ///< First invariant of f
+    double g3; ///< Second invariant of f
+    double scale; ///< Natural Mino-time scale of &weierp; is 1/scale
+    double laurent[12]; ///< Laurent coefficients of &weierp;, from index 2
+    /// Set coefficients, invariants and Laurent coefficients
+    void set(double c0, double c1, double c2, double c3, double c4);
+    /// &weierp;(z) and &weierp;'(z) for real z
+    void weierstrass(double z, double &p, double &dp) const;
+    /// Solution x(dl) of the equation with x(0)=x0, sign(x'(0))=sign(dx0)
+    void solve(double x0, double dx0, double dl, double &x, double &dx) const;
+  };
+
+  /// Constants of motion of a geodesic
+  struct Constants {
+    double E; ///< Energy -p<SUB>t</SUB>
+    double L; ///< Angular momentum p<SUB>&phi;</SUB>
+    double Q; ///< Carter constant
+    Potential r; ///< Radial potential R(r)
+    Potential u; ///< Polar potential U(u), u=cos&theta;
+  };
+
+ private:
+  double spin_; ///< Spin parameter a of the KerrBL metric
+  double mu2_; ///< Square of the mass of the particle: 0 or 1
+  double rhor_; ///< Radius of the event horizon
+  Constants cst_; ///< Constants of the geodesic being integrated
+  state_t coord_; ///< Current position-velocity
+
+ public:
+  /// Constructor
+  KerrAnalytic(Worldline *parent);
+  KerrAnalytic * clone(Worldline*newparent) const ;
+  virtual ~KerrAnalytic();
+  virtual void init();
+  virtual void init(Worldline * line, const state_t &coord, const double delta);
+  virtual std::string kind();
+
+  virtual int nextStep(state_t &coord, double &tau, double h1max=1e6);
+
+  /**
+   * Exact: the geodesic is propagated analytically from coordin by
+   * step in proper time (or affine parameter).
+   */
+  virtual void doStep(state_t const &coordin, 
+		      double step,
+		      state_t &coordout);
+
+  /// True: doStep() is analytic
+  virtual bool exact() const;
+
+ protected:
+  /// Compute the constants of motion of the geodesic through coord
+  void constants(state_t const &coord, Constants &cst) const;
+
+  /// Propagate by Mino time dl
+  /**
+   * \param[in] cst constants of the geodesic through coordin;
+   * \param[in] coordin initial position-velocity;
+   * \param[in] dl Mino time step;
+   * \param[out] coordout final position-velocity;
+   * \param[out] dtau elapsed proper time or affine parameter.
+   */
+  void propagate(Constants const &cst, state_t const &coordin, double dl,
+		 state_t &coordout, double &dtau) const;
+};
+
 #ifdef GYOTO_HAVE_BOOST_INTEGRATORS
 /**
  * \class Gyoto::Worldline::IntegState::Boost
@@ -973,6 +1254,11 @@ class Gyoto::Worldline::IntegState::Legacy : public Generic {
  * pass one of "runge_kutta_cash_karp54", "runge_kutta_fehlberg78",
  * "runge_kutta_dopri5", or "runge_kutta_cash_karp54_classic" to
  * Worldline::integrator(std::string type).
+ *
+ * If Worldline::hamiltonian() is true, the integrators evolve the
+ * state (x<SUP>&mu;</SUP>, p<SUB>&mu;</SUB>) using
+ * Metric::Generic::diffHamiltonian(). nextStep() and doStep() still
+ * take and return (x<SUP>&mu;</SUP>, dx<SUP>&mu;</SUP>/d&lambda;).
  */
 class Gyoto::Worldline::IntegState::Boost : public Generic {
   friend class Gyoto::SmartPointer<Gyoto::Worldline::IntegState::Boost>;
@@ -994,6 +1280,8 @@ class Gyoto::Worldline::IntegState::Boost : public Generic {
   typedef std::function<void(const state_t &/*x*/,
 			     state_t & /*dxdt*/,
 			     const double /* t*/ )> system_t;
+  typedef std::function<void(state_t const&, double, double, state_t&)>
+    dense_step_t;
 
   /// Stepper used by the adaptive-step integrator
   try_step_t try_step_;
@@ -1001,6 +1289,31 @@ class Gyoto::Worldline::IntegState::Boost : public Generic {
   /// Stepper used by the non-adaptive-step integrator
   do_step_t do_step_;
 
+  /// Dense output of the stepper (runge_kutta_dopri5 only), see denseStep()
+  dense_step_t dense_step_;
+
+  /// Whether to integrate the covariant momentum (see Worldline::hamiltonian_)
+  bool hamiltonian_;
+
+  /// Last state integrated in Hamiltonian form, as (x<SUP>&mu;</SUP>, p<SUB>&mu;</SUB>)
+  state_t ham_state_;
+
+  /// Last state returned by nextStep() in Hamiltonian form
+  /**
+   * Same as #ham_state_ with the 4-velocity instead of the
+   * momentum. If nextStep() is called again with this state, the
+   * integration resumes from #ham_state_ and the momentum is not
+   * recomputed: the conserved components of p<SUB>&mu;</SUB> then
+   * remain exact over the whole Worldline.
+   */
+  state_t ham_coord_;
+
+  /// Lower the velocity in coord: (x, dx/d&lambda;) &rarr; (x, p)
+  void toMomentum(state_t const &coord, state_t &ham) const;
+
+  /// Raise the momentum in ham: (x, p) &rarr; (x, dx/d&lambda;)
+  void toVelocity(state_t const &ham, state_t &coord) const;
+
  public:
   /// Constructor
   /**
@@ -1025,6 +1338,13 @@ class Gyoto::Worldline::IntegState::Boost : public Generic {
   virtual void doStep(state_t const &coordin, 
 		      double step,
 		      state_t &coordout);
+  /**
+   * Only runge_kutta_dopri5 has a continuous extension. It is the
+   * order-4 polynomial of Dormand and Prince, evaluated from the
+   * stages of the step.
+   */
+  virtual bool denseStep(state_t const &coordin, double step, double frac,
+			 state_t &coordout);
   virtual std::string kind();
   
 };
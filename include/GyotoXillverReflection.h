@@ -58,7 +58,7 @@ class Gyoto::Astrobj::XillverReflection
    * format, the first dimension is nu, the second is incl (the emission angle),
    * and the third is log(ionization parameter).
    */
-  double * reflection_; 
+  SharedArray<double> reflection_; 
 
   double * logxi_; ///< log of ionization param
   double * incl_; ///< emission angle
@@ -67,7 +67,7 @@ class Gyoto::Astrobj::XillverReflection
   size_t ni_; ///< Number of emission angles
   size_t nxi_; ///< Number of log(ionization param)
 
-  double * illumination_;
+  SharedArray<double> illumination_;
 
   double * radius_; ///< radii at which illumination is known
   double * phi_; ///< azimuthal angle at which illumination is known
@@ -120,12 +120,12 @@ class Gyoto::Astrobj::XillverReflection
   /**
    * The pointer is copied directly, not the array content.
    *
-   * This is a low-level function. Beware that:
-   *  - previously allocated array will not be freed automatically;
-   *  - array attached when the destructor is called will be freed.
+   * This is a low-level function. The array is borrowed (see
+   * SharedArray::borrow()): it remains owned by the caller, who must
+   * keep it alive while it is in use.
    */
-  void setIllumination(double * pattern);
-  void setReflection(double * pattern);
+  void setIllumination(double const * pattern);
+  void setReflection(double const * pattern);
   
   
   /**
@@ -536,6 +536,8 @@ class Gyoto::Astrobj::Python::ThinDisk
   /* Astrobj::ThinDisk API */
   virtual double operator()(double const coord[4]) ;
   virtual void getVelocity(double const pos[4], double vel[4]) ;
+  /// ThinDisk::boundingVolume() unless the class implements __call__
+  virtual void boundingVolume(double t1, double t2, BoundingVolume &bv);
 
   /* Python::Base */
   virtual std::string module() const ;
@@ -673,6 +673,23 @@ ExtendArrayNumPy(array_size_t, size_t);
   // void getCoord(size_t index, Gyoto::Worldline::state_type &ARGOUT_ARRAY1) {
   //   ($self)->getCoord(index, ARGOUT_ARRAY1);
   // }
+  // Gyoto::state_t is a FixedState, unknown to Python: support
+  // passing a vector_double instead.
+  void getInitialCoord(std::vector<double> &dest) const {
+    Gyoto::state_t coord(dest.size());
+    ($self)->getInitialCoord(coord);
+    dest=coord;
+  }
+  void getCoord(size_t index, std::vector<double> &dest) const {
+    Gyoto::state_t coord(dest.size());
+    ($self)->getCoord(index, coord);
+    dest=coord;
+  }
+  void getCoord(double date, std::vector<double> &dest, bool proper=false) {
+    Gyoto::state_t coord(dest.size());
+    ($self)->getCoord(date, coord, proper);
+    dest=coord;
+  }
   void getCartesianPos(size_t index, double ARGOUT_ARRAY1[8]) {
     ($self)->getCartesianPos(index, ARGOUT_ARRAY1);
   }
@@ -731,9 +748,28 @@ GyotoSmPtrClassDerivedPtrHdr(Astrobj, Standard, StandardAstrobj, GyotoStandardAs
   void gmunu(double ARGOUT_ARRAY2[4][4], double const IN_ARRAY1[4]) {
     ($self)->gmunu(ARGOUT_ARRAY2, IN_ARRAY1);
   }
+  void gmunu_up(double ARGOUT_ARRAY2[4][4], double const IN_ARRAY1[4]) {
+    ($self)->gmunu_up(ARGOUT_ARRAY2, IN_ARRAY1);
+  }
   void christoffel(double ARGOUT_ARRAY3[4][4][4], double const IN_ARRAY1[4]) {
     ($self)->christoffel(ARGOUT_ARRAY3, IN_ARRAY1);
   }
+  // Gyoto::state_t is a FixedState, unknown to Python: support
+  // passing a vector_double instead. With dense=True, call
+  // Generic::diff(), which contracts all the Christoffel symbols, to
+  // validate the restricted contraction of the derived class. repeat
+  // is for timing it, see doc/examples/benchmark-christoffel-traits.py.
+  int diff(std::vector<double> const &x, std::vector<double> &dxdt,
+	   double mass=0., bool dense=false, size_t repeat=1) const {
+    Gyoto::state_t xs(x), ds(x.size());
+    int res=0;
+    for (size_t k=0; k<repeat; ++k)
+      res = dense ?
+	($self)->Gyoto::Metric::Generic::diff(xs, ds, mass) :
+	($self)->diff(xs, ds, mass);
+    dxdt=ds;
+    return res;
+  }
 };
 GyotoSmPtrClassGeneric(Metric)
 GyotoSmPtrClassGeneric(Spectrum)
@@ -101,6 +101,42 @@ class TestSmartPointer(unittest.TestCase):
             del cplx1
             del cplx
 
+    def test_threads(self):
+        '''Test that concurrent copies of SmartPointers balance out
+
+        Each ray copies SmartPointers to the objects shared by all
+        threads: ray-trace with many threads and check the counters
+        come back to their initial values.
+        '''
+        met=gyoto.core.Metric("KerrBL")
+        ao=gyoto.core.Astrobj("PageThorneDisk")
+        ao.metric(met)
+        ao.opticallyThin(False)
+        ao.rMax(100)
+        spr=gyoto.core.Spectrometer("wave")
+        screen=gyoto.core.Screen()
+        screen.metric(met)
+        screen.distance(100, "geometrical")
+        screen.time(100, "geometrical")
+        screen.resolution(32)
+        screen.inclination(numpy.pi/4)
+        screen.fieldOfView(numpy.pi/8)
+        screen.spectrometer(spr)
+        sc=gyoto.core.Scenery()
+        sc.metric(met)
+        sc.astrobj(ao)
+        sc.screen(screen)
+        # PageThorneDisk only computes the bolometric intensity
+        sc.requestedQuantitiesString('User4')
+        counts=[obj.getRefCount() for obj in (met, ao, spr, screen)]
+        for nthreads in (1, 8):
+            sc.nThreads(nthreads)
+            for k in range(4):
+                sc.rayTrace()
+            self.assertEqual(
+                [obj.getRefCount() for obj in (met, ao, spr, screen)],
+                counts)
+
 class TestUnit(unittest.TestCase):
 
     def test___str__(self):
@@ -181,6 +217,16 @@ class TestMetric(unittest.TestCase):
         dst2=gg.gmunu((0, 6, 3.14, 0))
         self.assertEqual(tt, dst2[0, 0])
 
+    def test_gmunu_up(self):
+        for kind, pos in (('KerrBL', (0, 6, 1.2, 0)),
+                          ('KerrKS', (0, 3, -2, 1.5))):
+            gg=gyoto.core.Metric(kind)
+            gg.set('Spin', 0.7)
+            gup=gg.gmunu_up(pos)
+            g=gg.gmunu(pos)
+            self.assertLess(numpy.abs(numpy.dot(g, gup)-numpy.eye(4)).max(),
+                            1e-12)
+
     def test_christoffel(self):
         gg=gyoto.core.Metric('KerrBL')
         tt=gg.christoffel((0, 6, 3.14, 0), 0, 0, 0)
@@ -356,6 +402,23 @@ class TestProperty(unittest.TestCase):
         p=s.property('Distance')
         self.assertIn('Distance: double with unit', s.describeProperty(p))
 
+class TestBoundingVolume(unittest.TestCase):
+    def test_reaches(self):
+        bv=gyoto.core.BoundingVolume()
+        self.assertTrue(bv.reaches((100., 0., 0.), (101., 0., 0.)))
+        bv.sphere((0., 0., 0.), 1.)
+        self.assertTrue(bv.reaches((-5., 0.5, 0.), (5., 0.5, 0.)))
+        self.assertFalse(bv.reaches((10., 0., 0.), (11., 0., 0.)))
+        bv.slab(0., 0., 10.)
+        self.assertTrue(bv.reaches((5., 0., 1.), (5., 0., -1.)))
+        self.assertFalse(bv.reaches((5., 0., 5.), (5., 0., 6.)))
+        self.assertFalse(bv.reaches((50., 0., 1.), (50., 0., -1.)))
+        bv.cone(0.1, 100.)
+        self.assertTrue(bv.reaches((0., 0., 50.), (0., 0., 51.)))
+        self.assertTrue(bv.reaches((0., 0., -50.), (0., 0., -51.)))
+        self.assertFalse(bv.reaches((50., 0., 1.), (51., 0., 1.)))
+        self.assertFalse(bv.reaches((0., 0., 200.), (0., 0., 201.)))
+
 class TestPolar(unittest.TestCase):
     def test_triad(self):
         met=gyoto.core.Metric("KerrBL")
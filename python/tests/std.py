@@ -11,6 +11,62 @@ class TestChernSimons(unittest.TestCase):
         gg.dzetaCS(zeta)
         self.assertTrue((gg.dzetaCS() == zeta))
 
+class TestComplexAstrobj(unittest.TestCase):
+
+    def _scenery(self):
+        met=gyoto.std.KerrBL()
+        met.spin(0.5)
+        # Both objects must compute Intensity: PageThorneDisk, which
+        # only computes User4, would not do
+        disk=gyoto.core.Astrobj("ThinDisk")
+        disk.metric(met)
+        disk.opticallyThin(False)
+        disk.set("InnerRadius", 6.)
+        disk.set("OuterRadius", 15.)
+        disk.rMax(50.)
+        sp=gyoto.core.Spectrum("PowerLaw")
+        sp.set("Exponent", 0.)
+        sp.set("Constant", 0.001)
+        op=gyoto.core.Spectrum("PowerLaw")
+        op.set("Exponent", 0.)
+        op.set("Constant", 0.01)
+        star=gyoto.core.Astrobj("FixedStar")
+        star.metric(met)
+        star.set("Radius", 3.)
+        star.set("Position", (12., numpy.pi/2.-0.4, 0.5))
+        star.set("Spectrum", sp)
+        star.set("Opacity", op)
+        star.opticallyThin(True)
+        ao=gyoto.std.ComplexAstrobj()
+        ao.metric(met)
+        ao.append(disk)
+        ao.append(star)
+        screen=gyoto.core.Screen()
+        screen.metric(met)
+        screen.distance(100., "geometrical")
+        screen.time(100., "geometrical_time")
+        screen.resolution(16)
+        screen.inclination(numpy.pi/3.)
+        screen.fieldOfView(numpy.pi/8.)
+        sc=gyoto.core.Scenery()
+        sc.metric(met)
+        sc.astrobj(ao)
+        sc.screen(screen)
+        sc.nThreads(1)
+        sc.requestedQuantitiesString('Intensity EmissionTime')
+        return sc, ao
+
+    def test_culling(self):
+        # The bounding volumes only spare work: the image is the same
+        sc, ao=self._scenery()
+        self.assertTrue(ao.culling())
+        ref=sc.rayTrace()
+        ao.culling(False)
+        res=sc.rayTrace()
+        self.assertGreater((ref['Intensity']>0.).sum(), 0)
+        for q in ('Intensity', 'EmissionTime'):
+            numpy.testing.assert_allclose(res[q], ref[q], rtol=1e-12)
+
 class TestDeformedTorus(unittest.TestCase):
 
     def test_DeformedTorus(self):
@@ -29,6 +85,94 @@ class TestDynamicalDiskBolometric(unittest.TestCase):
         ao=gyoto.std.DynamicalDiskBolometric()
         self.assertTrue(True)
 
+class TestDynamicalDisk(unittest.TestCase):
+
+    def _write_slices(self, dirname, ntimes, nnu=1, nphi=4, nr=8):
+        import os
+        naxes=numpy.asarray([nnu, nphi, nr], dtype=numpy.uintp)
+        radius=numpy.linspace(3., 28., nr)
+        for k in range(ntimes):
+            pd=gyoto.std.PatternDisk()
+            pd.copyIntensity(gyoto.core.array_double.fromnumpy3
+                             ((k+1.)*numpy.ones((nr, nphi, nnu))),
+                             gyoto.core.array_size_t.fromnumpy1(naxes))
+            velocity=numpy.zeros((nr, nphi, 2))
+            velocity[:, :, 0]=0.1*(k+1.)
+            pd.copyVelocity(gyoto.core.array_double.fromnumpy3(velocity),
+                            gyoto.core.array_size_t.fromnumpy1(naxes[1:]))
+            pd.copyGridRadius(gyoto.core.array_double.fromnumpy1(radius), nr)
+            pd.fitsWrite(os.path.join(dirname, 'data%04i.fits.gz' % (k+1)))
+
+    def _sweep(self, dd, ntimes):
+        vel=numpy.zeros(4)
+        for t in numpy.linspace(0., ntimes-1., 2*ntimes):
+            pos=numpy.asarray([t, 10., numpy.pi/2., 0.])
+            dd.getVelocity(pos, vel)
+
+    def test_slice_cache(self):
+        import os, shutil, tempfile
+        if not hasattr(gyoto.std.PatternDisk(), 'fitsWrite'):
+            self.skipTest('needs FITS support')
+        ntimes=4
+        tmpdir=tempfile.mkdtemp()
+        try:
+            self._write_slices(tmpdir, ntimes)
+            # Unlimited budget: each date is read once
+            dd=gyoto.std.DynamicalDisk()
+            dd.metric(gyoto.std.KerrBL())
+            dd.prefetch(False)
+            dd.file(tmpdir+os.sep)
+            self._sweep(dd, ntimes)
+            self.assertEqual(dd.cacheMisses(), ntimes)
+            self._sweep(dd, ntimes)
+            self.assertEqual(dd.cacheMisses(), ntimes)
+            self.assertGreater(dd.cacheHits(), 0)
+            # Budget for one date only: dates are read again
+            dd=gyoto.std.DynamicalDisk()
+            dd.metric(gyoto.std.KerrBL())
+            dd.prefetch(False)
+            dd.cacheBudget(8)
+            dd.file(tmpdir+os.sep)
+            self._sweep(dd, ntimes)
+            self._sweep(dd, ntimes)
+            self.assertGreater(dd.cacheMisses(), ntimes)
+        finally:
+            shutil.rmtree(tmpdir)
+
+    def test_prefetch(self):
+        import os, shutil, tempfile
+        if not hasattr(gyoto.std.PatternDisk(), 'fitsWrite'):
+            self.skipTest('needs FITS support')
+        ntimes=6
+        tmpdir=tempfile.mkdtemp()
+        try:
+            self._write_slices(tmpdir, ntimes)
+            vel={}
+            for prefetch in (False, True):
+                dd=gyoto.std.DynamicalDisk()
+                dd.metric(gyoto.std.KerrBL())
+                dd.prefetch(prefetch)
+                dd.file(tmpdir+os.sep)
+                vel[prefetch]=[]
+                for t in numpy.linspace(0., ntimes-1., 4*ntimes):
+                    v=numpy.zeros(4)
+                    dd.getVelocity(numpy.asarray([t, 10., numpy.pi/2., 0.]),
+                                   v)
+                    vel[prefetch].append(v)
+                # Each date is read exactly once, by get() or ahead
+                self.assertEqual(dd.cacheMisses()+dd.cachePrefetched(),
+                                 ntimes)
+                if prefetch:
+                    # The first date read ahead is the second one,
+                    # which get() then waits for
+                    self.assertGreater(dd.cachePrefetched(), 0)
+                else:
+                    self.assertEqual(dd.cachePrefetched(), 0)
+            numpy.testing.assert_array_equal(numpy.asarray(vel[True]),
+                                             numpy.asarray(vel[False]))
+        finally:
+            shutil.rmtree(tmpdir)
+
 class TestEquatorialHotSpot(unittest.TestCase):
 
     def test_EquatorialHotSpot(self):
@@ -110,6 +254,117 @@ class TestStar(unittest.TestCase):
         st.getInitialCoord(dst2)
         self.assertTrue((numpy.asarray(dst) == numpy.asarray(dst2)).all())
 
+    def test_denseOutput(self):
+        # dopri5 has its own dense output, fehlberg78 uses the
+        # Hermite polynomial
+        for integrator in ("runge_kutta_dopri5", "runge_kutta_fehlberg78"):
+            st=gyoto.std.Star()
+            self.assertFalse(st.denseOutput())
+            st.metric(gyoto.std.KerrBL())
+            st.integrator(integrator)
+            st.setInitCoord((0., 9., 1.5707999999999999741, 0),
+                            (0., 0., 0.037037))
+            st.xFill(1000.)
+            n=st.get_nelements()
+            t=numpy.ndarray(n)
+            st.get_t(t)
+            # midpoints between steps, where interpolation is needed
+            dates=0.5*(t[1:]+t[:-1])
+            res={}
+            for dense in (False, True):
+                st.denseOutput(dense)
+                res[dense]=[numpy.ndarray(n-1) for k in range(7)]
+                st.getCoord(dates, *res[dense])
+            for k in range(7):
+                self.assertLess(numpy.abs(res[True][k]-res[False][k]).max(),
+                                1e-4*(1.+numpy.abs(res[False][k]).max()))
+
+    def test_startrace_distance(self):
+        met=gyoto.std.Minkowski()
+        met.keplerian(True)
+        st=gyoto.std.StarTrace()
+        st.metric(met)
+        pos=[0., 10., 0., 0.]
+        st.initCoord(numpy.append(pos, met.circularVelocity(pos)))
+        st.TMax(1500.)
+        st.TMin(100.)
+        st.xFill(2000.)
+        n=st.get_nelements()
+        t=numpy.ndarray(n)
+        x=numpy.ndarray(n)
+        y=numpy.ndarray(n)
+        z=numpy.ndarray(n)
+        st.get_t(t)
+        st.get_xyz(x, y, z)
+        sel=(t>=100.) & (t<=1500.)
+        rng=numpy.random.RandomState(0)
+        for k in range(50):
+            p=rng.uniform(-15., 15., 3)
+            d2=((x[sel]-p[0])**2+(y[sel]-p[1])**2+(z[sel]-p[2])**2).min()
+            self.assertEqual(st(numpy.append(0., p)), d2)
+        # Changing the time window must rebuild the index
+        st.TMax(200.)
+        sel=(t>=100.) & (t<=200.)
+        p=numpy.asarray([0., -10., 0., 0.])
+        d2=((x[sel]-p[1])**2+(y[sel]-p[2])**2+(z[sel]-p[3])**2).min()
+        self.assertEqual(st(p), d2)
+
+class TestChristoffelTraits(unittest.TestCase):
+    '''diff() contracts only the non-zero Christoffel symbols'''
+
+    def _metrics(self):
+        bl=gyoto.std.KerrBL()
+        bl.spin(0.7)
+        ks=gyoto.std.KerrKS()
+        ks.spin(0.7)
+        mks=gyoto.std.Minkowski()
+        mks.spherical(True)
+        mkc=gyoto.std.Minkowski()
+        mkc.spherical(False)
+        return {'KerrBL': (bl, True), 'KerrKS': (ks, False),
+                'Minkowski spherical': (mks, True),
+                'Minkowski Cartesian': (mkc, False)}
+
+    def _state(self, rng, spherical, nvec):
+        r=rng.uniform(4., 20.)
+        th=rng.uniform(0.3, numpy.pi-0.3)
+        ph=rng.uniform(0., 2.*numpy.pi)
+        if spherical:
+            pos=[0., r, th, ph]
+        else:
+            pos=[0., r*numpy.sin(th)*numpy.cos(ph),
+                 r*numpy.sin(th)*numpy.sin(ph), r*numpy.cos(th)]
+        vel=rng.uniform(-0.1, 0.1, 4*nvec)
+        vel[0]=rng.uniform(1., 2.)
+        return numpy.concatenate((pos, vel))
+
+    def _reference(self, met, x):
+        # Contraction of all 64 symbols with numpy
+        G=met.christoffel(x[:4])
+        res=numpy.zeros(x.size)
+        res[:4]=x[4:8]
+        for v in range(1, x.size//4):
+            res[4*v:4*v+4]=-numpy.einsum('amn,m,n->a', G, x[4:8],
+                                         x[4*v:4*v+4])
+        return res
+
+    def test_diff(self):
+        rng=numpy.random.RandomState(0)
+        for name, (met, spherical) in self._metrics().items():
+            # Geodesic alone, then with parallel transport
+            for nvec in (1, 3):
+                for k in range(20):
+                    x=self._state(rng, spherical, nvec)
+                    ref=self._reference(met, x)
+                    scale=1.+numpy.abs(ref).max()
+                    for dense in (False, True):
+                        dxdt=gyoto.core.vector_double(x.size)
+                        met.diff(gyoto.core.vector_double(x.tolist()), dxdt,
+                                 0., dense)
+                        self.assertLess(
+                            numpy.abs(numpy.asarray(dxdt)-ref).max(),
+                            1e-12*scale, name)
+
 class TestMinkowski(unittest.TestCase):
 
     def _compute_r_norm(self, met, st, pos, v, tmax=1e6):
@@ -216,3 +471,513 @@ class TestMinkowski(unittest.TestCase):
         r, norm=self._compute_r_norm(met, st, pos, v, tmax=50.)
         self.assertLess( numpy.abs(r-3.).max(), 1e-6)
         self.assertLess( numpy.abs(norm+1.).max(), 1e-6 )
+
+class TestPhotonScratch(unittest.TestCase):
+
+    def test_no_allocation_per_ray(self):
+        '''Rendering an optically thin object that only implements
+        emission() and transmission(), which processHitQuantities()
+        reaches through the default radiativeQ(), must not reallocate
+        the scratch memory of the Photon'''
+        gg=gyoto.core.Metric("Minkowski")
+        gg.set("Spherical", False)
+        sp=gyoto.core.Spectrum("PowerLaw")
+        sp.set("Exponent", 0.)
+        sp.set("Constant", 0.001)
+        op=gyoto.core.Spectrum("PowerLaw")
+        op.set("Exponent", 0.)
+        op.set("Constant", 0.01)
+        ao=gyoto.core.Astrobj("FixedStar")
+        ao.metric(gg)
+        ao.set("Radius", 12.)
+        ao.set("Position", (0., 0., 0.))
+        ao.set("Spectrum", sp)
+        ao.set("Opacity", op)
+        ao.opticallyThin(True)
+        spectro=gyoto.core.Spectrometer("freqlog")
+        spectro.set("NSamples", 50)
+        spectro.set("Band", (14., 16.))
+        scr=gyoto.core.Screen()
+        scr.metric(gg)
+        scr.distance(100.)
+        scr.inclination(numpy.pi/2.)
+        ph=gyoto.core.Photon()
+        ph.spectrometer(spectro)
+        ph.delta(1.)
+        nallocs=ph.scratchAllocations()
+        self.assertEqual(nallocs, 1)
+        # The whole image, star and background, in one Photon
+        angles=numpy.linspace(-0.15, 0.15, 9)
+        spectrum=numpy.zeros(50, dtype=float)
+        hits=0
+        for alpha in angles:
+            for delta in angles:
+                ph.setInitialCondition(gg, ao, scr, alpha, delta)
+                ph.spectrometer(spectro)
+                ph.delta(1.)
+                spectrum[:]=0.
+                aop=gyoto.core.AstrobjProperties()
+                aop.spectrum=gyoto.core.array_double.fromnumpy1(spectrum)
+                aop.offset=1
+                ph.hit(aop)
+                hits+=(spectrum.max() > 0.)
+        self.assertGreater(hits, 0)
+        self.assertLess(hits, len(angles)**2)
+        self.assertEqual(ph.scratchAllocations(), nallocs)
+
+class TestKerrAnalytic(unittest.TestCase):
+
+    def _star(self, integrator):
+        gg=gyoto.std.KerrBL()
+        gg.spin(0.7)
+        st=gyoto.std.Star()
+        st.metric(gg)
+        st.integrator(integrator)
+        st.absTol(1e-12)
+        st.relTol(1e-12)
+        st.setInitCoord((0., 9., 1.3, 0), (0., 0.005, 0.035))
+        st.xFill(1000.)
+        return st
+
+    def test_star(self):
+        ref=self._star("runge_kutta_fehlberg78")
+        st=self._star("KerrAnalytic")
+        self.assertEqual(st.integrator(), "KerrAnalytic")
+        dates=numpy.linspace(10., 990., 50)
+        res={}
+        for line in (ref, st):
+            res[line]=[numpy.ndarray(50) for k in range(7)]
+            line.getCoord(dates, *res[line])
+        for k in range(3):
+            self.assertLess(numpy.abs(res[st][k]-res[ref][k]).max(), 1e-5)
+
+    def test_dense(self):
+        # Between the (long) steps of KerrAnalytic, getCoord() must
+        # use the exact solution even if dense output is requested
+        ref=self._star("runge_kutta_fehlberg78")
+        st=self._star("KerrAnalytic")
+        st.denseOutput(True)
+        n=st.get_nelements()
+        t=numpy.ndarray(n)
+        st.get_t(t)
+        dates=0.5*(t[1:]+t[:-1])
+        dates=dates[(dates>t.min()) & (dates<t.max())]
+        res={}
+        for line in (ref, st):
+            res[line]=[numpy.ndarray(dates.size) for k in range(7)]
+            line.getCoord(dates, *res[line])
+        for k in range(3):
+            self.assertLess(numpy.abs(res[st][k]-res[ref][k]).max(), 1e-5)
+
+    def test_thindisk(self):
+        hits={}
+        for integrator in ("runge_kutta_fehlberg78", "KerrAnalytic"):
+            gg=gyoto.std.KerrBL()
+            gg.spin(0.5)
+            td=gyoto.core.Astrobj("ThinDisk")
+            td.metric(gg)
+            td.set("InnerRadius", 3.)
+            td.set("OuterRadius", 20.)
+            scr=gyoto.core.Screen()
+            scr.metric(gg)
+            scr.distance(1000., "geometrical")
+            scr.time(1000., "geometrical_time")
+            scr.inclination(1.)
+            ph=gyoto.core.Photon()
+            ph.integrator(integrator)
+            hits[integrator]=[]
+            for b in numpy.linspace(-25., 25., 11):
+                ph.setInitialCondition(gg, td, scr, b*1e-3, 0.)
+                hits[integrator].append(ph.hit())
+        self.assertEqual(hits["KerrAnalytic"], hits["runge_kutta_fehlberg78"])
+        self.assertGreater(sum(hits["KerrAnalytic"]), 0)
+
+class TestPacket(unittest.TestCase):
+
+    def _scenery(self, integrator, met):
+        met.spin(0.5)
+        ao=gyoto.core.Astrobj("PageThorneDisk")
+        ao.metric(met)
+        ao.opticallyThin(False)
+        ao.rMax(50.)
+        screen=gyoto.core.Screen()
+        screen.metric(met)
+        screen.distance(100., "geometrical")
+        screen.time(100., "geometrical_time")
+        screen.resolution(16)
+        screen.inclination(numpy.pi/3.)
+        screen.fieldOfView(numpy.pi/8.)
+        sc=gyoto.core.Scenery()
+        sc.metric(met)
+        sc.astrobj(ao)
+        sc.screen(screen)
+        sc.integrator(integrator)
+        sc.nThreads(1)
+        # PageThorneDisk only computes the bolometric intensity
+        sc.requestedQuantitiesString('User4 EmissionTime')
+        return sc
+
+    def _compare(self, integrator, met=None):
+        if met is None: met=gyoto.std.KerrBL()
+        sc=self._scenery(integrator, met)
+        ref=sc.rayTrace()
+        sc.packetSize(8)
+        res=sc.rayTrace()
+        return ref, res
+
+    def _check_dopri5(self, met):
+        # Packets reproduce the scalar dopri5 within tolerance
+        ref, res=self._compare("runge_kutta_dopri5", met)
+        hit=numpy.isfinite(ref['EmissionTime']) & (ref['User4']>0.)
+        self.assertGreater(hit.sum(), 0)
+        self.assertTrue(((res['User4']>0.) == (ref['User4']>0.)).all())
+        self.assertLess(numpy.abs(res['EmissionTime'][hit]
+                                  -ref['EmissionTime'][hit]).max(), 1e-3)
+        self.assertLess(numpy.abs(res['User4']-ref['User4']).max(),
+                        1e-4*ref['User4'].max())
+
+    def test_dopri5(self):
+        self._check_dopri5(gyoto.std.KerrBL())
+
+    def test_dopri5_ks(self):
+        self._check_dopri5(gyoto.std.KerrKS())
+
+    def test_other_integrator(self):
+        # Any other integrator is not run in packets
+        ref, res=self._compare("runge_kutta_fehlberg78")
+        for q in ('User4', 'EmissionTime'):
+            numpy.testing.assert_array_equal(res[q], ref[q])
+
+class TestFarField(unittest.TestCase):
+
+    def _photon(self, ffr):
+        gg=gyoto.std.KerrBL()
+        gg.spin(0.5)
+        ao=gyoto.core.Astrobj("FixedStar")
+        ao.metric(gg)
+        ao.set("Radius", 2.)
+        ao.set("Position", (8., numpy.pi/2., 0.))
+        ao.rMax(20.)
+        scr=gyoto.core.Screen()
+        scr.metric(gg)
+        scr.distance(1e5, "geometrical")
+        scr.time(1e5, "geometrical_time")
+        scr.inclination(numpy.pi/2.)
+        ph=gyoto.core.Photon()
+        ph.setInitialCondition(gg, ao, scr, 0., 0.)
+        ph.set("FarFieldRadius", ffr)
+        return ph, gg, ao, scr
+
+    def test_farfield(self):
+        ph, gg, ao, scr=self._photon(0.)
+        ph_ff, gg_ff, ao_ff, scr_ff=self._photon(1000.)
+        self.assertEqual(ph_ff.get("FarFieldRadius"), 1000.)
+        steps=0
+        steps_ff=0
+        for b in numpy.linspace(-30., 30., 13):
+            ph.setInitialCondition(gg, ao, scr, b*1e-5, 0.)
+            ph_ff.setInitialCondition(gg_ff, ao_ff, scr_ff, b*1e-5, 0.)
+            self.assertEqual(ph_ff.hit(), ph.hit())
+            steps+=ph.get_nelements()
+            steps_ff+=ph_ff.get_nelements()
+        self.assertLess(steps_ff, steps)
+
+    def _emission(self, ph):
+        n=ph.get_nelements()
+        t=numpy.ndarray(n)
+        ph.get_t(t)
+        return t.min()
+
+    def test_accuracy(self):
+        ph, gg, ao, scr=self._photon(0.)
+        ph_ff, gg_ff, ao_ff, scr_ff=self._photon(1000.)
+        nhits=0
+        for b in numpy.linspace(-30., 30., 13):
+            ph.setInitialCondition(gg, ao, scr, b*1e-5, 0.)
+            ph_ff.setInitialCondition(gg_ff, ao_ff, scr_ff, b*1e-5, 0.)
+            if not ph.hit(): continue
+            self.assertTrue(ph_ff.hit())
+            nhits+=1
+            # Date of emission, up to the last integration step
+            t0=self._emission(ph)
+            t0_ff=self._emission(ph_ff)
+            self.assertLess(abs(t0_ff-t0), 1.)
+            # Position along the geodesic close to the emitter. The
+            # far-field is first order in M/b, the residual is of
+            # order M^2/b at R.
+            dates=numpy.linspace(max(t0, t0_ff), max(t0, t0_ff)+20., 5)
+            res={}
+            for line in (ph, ph_ff):
+                res[line]=[numpy.ndarray(5) for k in range(7)]
+                line.getCoord(dates, *res[line])
+            self.assertLess(numpy.abs(res[ph_ff][0]-res[ph][0]).max(), 0.1)
+            for k in (1, 2):
+                self.assertLess(numpy.abs(res[ph_ff][k]-res[ph][k]).max(),
+                                0.1/8.)
+        self.assertGreater(nhits, 0)
+
+class TestFindValue(unittest.TestCase):
+
+    def _count(self, ao, alphas):
+        gg=ao.metric()
+        scr=gyoto.core.Screen()
+        scr.metric(gg)
+        scr.distance(1000., "geometrical")
+        scr.time(1000., "geometrical_time")
+        scr.inclination(1.)
+        ph=gyoto.core.Photon()
+        hits=0
+        for alpha in alphas:
+            ph.setInitialCondition(gg, ao, scr, alpha, 0.)
+            hits+=ph.hit()
+        self.assertGreater(hits, 0)
+        self.assertGreater(ph.findCount(), 0)
+        return ph.findEvalCount()/ph.findCount()
+
+    def test_thindisk(self):
+        td=gyoto.core.Astrobj("ThinDisk")
+        td.metric(gyoto.std.KerrBL())
+        td.set("InnerRadius", 3.)
+        td.set("OuterRadius", 20.)
+        # Bisection would take about 15 evaluations per crossing
+        self.assertLess(self._count(td, numpy.linspace(-25e-3, 25e-3, 11)),
+                        10.)
+
+    def test_star(self):
+        ao=gyoto.core.Astrobj("FixedStar")
+        ao.metric(gyoto.std.KerrBL())
+        ao.set("Radius", 2.)
+        ao.set("Position", (8., 1., 0.))
+        self.assertLess(self._count(ao, numpy.linspace(-10e-3, 10e-3, 11)),
+                        15.)
+
+    def _render(self, ao, quantity, bisection):
+        gg=ao.metric()
+        screen=gyoto.core.Screen()
+        screen.metric(gg)
+        screen.distance(100., "geometrical")
+        screen.time(100., "geometrical_time")
+        screen.resolution(16)
+        screen.inclination(numpy.pi/3.)
+        screen.fieldOfView(numpy.pi/8.)
+        sc=gyoto.core.Scenery()
+        sc.metric(gg)
+        sc.astrobj(ao)
+        sc.screen(screen)
+        sc.nThreads(1)
+        sc.requestedQuantitiesString(quantity+' EmissionTime')
+        self.assertFalse(sc.findBisection())
+        sc.findBisection(bisection)
+        return sc.rayTrace()
+
+    def _compare(self, ao, quantity):
+        # Brent's methods find the same dates as plain bisection, to
+        # GYOTO_T_TOL (1e-4) on either side of the exact one
+        ref=self._render(ao, quantity, True)
+        res=self._render(ao, quantity, False)
+        hit=(ref[quantity]>0.) & (res[quantity]>0.)
+        self.assertGreater(hit.sum(), 0)
+        self.assertLess(numpy.abs(res['EmissionTime'][hit]
+                                  -ref['EmissionTime'][hit]).max(), 2e-4)
+        return ref, res, hit
+
+    def test_thindisk_bisection(self):
+        # PageThorneDisk only computes the bolometric intensity
+        td=gyoto.std.PageThorneDisk()
+        td.metric(gyoto.std.KerrBL())
+        td.rMax(50.)
+        ref, res, hit=self._compare(td, 'User4')
+        numpy.testing.assert_array_equal(res['User4']>0., ref['User4']>0.)
+        numpy.testing.assert_allclose(res['User4'], ref['User4'],
+                                      rtol=1e-3)
+
+    def test_star_bisection(self):
+        # findMin() may decide differently for rays grazing the
+        # star, compare the others
+        ao=gyoto.core.Astrobj("FixedStar")
+        ao.metric(gyoto.std.KerrBL())
+        ao.set("Radius", 3.)
+        ao.set("Position", (12., numpy.pi/2.-0.4, 0.5))
+        ref, res, hit=self._compare(ao, 'Intensity')
+        self.assertGreater(hit.sum(), 0.9*(ref['Intensity']>0.).sum())
+
+class TestHamiltonian(unittest.TestCase):
+
+    def _star(self, gg, pos, vel, hamiltonian):
+        st=gyoto.std.Star()
+        st.metric(gg)
+        st.integrator("runge_kutta_fehlberg78")
+        st.hamiltonian(hamiltonian)
+        st.absTol(1e-12)
+        st.relTol(1e-12)
+        st.setInitCoord(pos, vel)
+        st.xFill(1000.)
+        return st
+
+    def test_property(self):
+        st=gyoto.std.Star()
+        self.assertFalse(st.get("Hamiltonian"))
+        st.set("Hamiltonian", True)
+        self.assertTrue(st.hamiltonian())
+
+    def test_star(self):
+        kbl=gyoto.std.KerrBL()
+        kbl.spin(0.7)
+        kks=gyoto.std.KerrKS()
+        kks.spin(0.7)
+        for gg, pos, vel in (
+                (kbl, (0., 9., 1.3, 0), (0., 0.005, 0.035)),
+                (kks, (0., 9., 0., 1.), (0.02, 0.3, 0.05)),
+                (gyoto.std.RezzollaZhidenko(), (0., 9., 1.3, 0),
+                 (0., 0.005, 0.035))):
+            ref=self._star(gg, pos, vel, False)
+            st=self._star(gg, pos, vel, True)
+            dates=numpy.linspace(10., 990., 50)
+            res={}
+            for line in (ref, st):
+                res[line]=[numpy.ndarray(50) for k in range(7)]
+                line.getCoord(dates, *res[line])
+            for k in range(7):
+                self.assertLess(numpy.abs(res[st][k]-res[ref][k]).max(),
+                                1e-5*(1.+numpy.abs(res[ref][k]).max()))
+
+    def test_conservation(self):
+        # p_t and p_phi are conserved exactly at each step
+        gg=gyoto.std.KerrBL()
+        gg.spin(0.7)
+        st=self._star(gg, (0., 9., 1.3, 0), (0., 0.005, 0.035), True)
+        n=st.get_nelements()
+        t=numpy.ndarray(n)
+        st.get_t(t)
+        res=[numpy.ndarray(n) for k in range(7)]
+        st.getCoord(t, *res)
+        p=numpy.ndarray((n, 2))
+        for i in range(n):
+            g=gg.gmunu((t[i], res[0][i], res[1][i], res[2][i]))
+            vel=(res[3][i], res[4][i], res[5][i], res[6][i])
+            p[i]=(numpy.dot(g[0], vel), numpy.dot(g[3], vel))
+        self.assertLess(numpy.abs(p-p[0]).max(), 1e-10*numpy.abs(p[0]).max())
+
+class TestPatternDisk(unittest.TestCase):
+
+    def _disk(self, nnu, nphi, nr):
+        gg=gyoto.std.KerrBL()
+        pd=gyoto.std.PatternDisk()
+        pd.metric(gg)
+        pd.innerRadius(3.)
+        pd.outerRadius(28.)
+        intensity=numpy.ones((nr, nphi, nnu))
+        naxes=numpy.asarray([nnu, nphi, nr], dtype=numpy.uintp)
+        pd.copyIntensity(gyoto.core.array_double.fromnumpy3(intensity),
+                         gyoto.core.array_size_t.fromnumpy1(naxes))
+        return pd, naxes
+
+    def _pool_scenery(self, ao):
+        scr=gyoto.core.Screen()
+        scr.metric(ao.metric())
+        scr.distance(100.)
+        scr.inclination(numpy.pi/4.)
+        scr.fieldOfView(0.3)
+        scr.resolution(16)
+        sc=gyoto.core.Scenery()
+        sc.metric(ao.metric())
+        sc.astrobj(ao)
+        sc.screen(scr)
+        sc.nThreads(2)
+        sc.threadPool(True)
+        sc.requestedQuantitiesString('Intensity')
+        return sc
+
+    def test_thread_pool(self):
+        '''The thread pool does not reuse clones of a mutated Astrobj'''
+        pd, naxes=self._disk(1, 8, 4)
+        sc=self._pool_scenery(pd)
+        ref=sc.rayTrace()['Intensity']
+        self.assertGreater(ref.max(), 0.)
+        # Through a setter
+        pd.copyIntensity(gyoto.core.array_double.fromnumpy3
+                         (2.*numpy.ones((4, 8, 1))),
+                         gyoto.core.array_size_t.fromnumpy1(naxes))
+        numpy.testing.assert_allclose(sc.rayTrace()['Intensity'], 2.*ref)
+        # Through a Property
+        pd.set("OuterRadius", 10.)
+        res=sc.rayTrace()['Intensity']
+        self.assertLess(numpy.count_nonzero(res), numpy.count_nonzero(ref))
+        # Through the Property of an element of a ComplexAstrobj
+        star=gyoto.core.Astrobj("FixedStar")
+        star.metric(pd.metric())
+        star.set("Radius", 2.)
+        star.set("Position", (10., numpy.pi/2., 0.))
+        ao=gyoto.std.ComplexAstrobj()
+        ao.metric(pd.metric())
+        ao.append(star)
+        sc=self._pool_scenery(ao)
+        ref=sc.rayTrace()['Intensity']
+        star.set("Radius", 5.)
+        res=sc.rayTrace()['Intensity']
+        self.assertGreater(numpy.count_nonzero(res), numpy.count_nonzero(ref))
+        # Appending an element
+        ao.append(pd)
+        ref=res
+        res=sc.rayTrace()['Intensity']
+        self.assertGreater(numpy.count_nonzero(res), numpy.count_nonzero(ref))
+
+    def test_shared_storage(self):
+        pd, naxes=self._disk(2, 8, 4)
+        clone=pd.clone()
+        self.assertEqual(int(clone.getIntensity()), int(pd.getIntensity()))
+        # Setting the intensity of the clone does not affect pd
+        intensity=2.*numpy.ones((4, 8, 2))
+        clone.copyIntensity(gyoto.core.array_double.fromnumpy3(intensity),
+                            gyoto.core.array_size_t.fromnumpy1(naxes))
+        self.assertNotEqual(int(clone.getIntensity()),
+                            int(pd.getIntensity()))
+        del pd
+        self.assertIsNotNone(clone.getIntensity())
+
+    def test_fits_map(self):
+        import os, sys, tempfile
+        nnu, nphi, nr=3, 8, 5
+        pd, naxes=self._disk(nnu, nphi, nr)
+        if not hasattr(pd, 'fitsWrite'):
+            self.skipTest('needs FITS support')
+        intensity=numpy.arange(nr*nphi*nnu, dtype=float).reshape((nr, nphi, nnu))
+        pd.copyIntensity(gyoto.core.array_double.fromnumpy3(intensity),
+                         gyoto.core.array_size_t.fromnumpy1(naxes))
+        tmpdir=tempfile.mkdtemp()
+        fname=os.path.join(tmpdir, 'pd.fits')
+        pd.fitsWrite(fname)
+        mode=gyoto.core.fitsMap()
+        gyoto.core.fitsMap(1)
+        try:
+            mapped=gyoto.std.PatternDisk()
+            mapped.file(fname)
+            # A second reader reuses the cache
+            again=gyoto.std.PatternDisk()
+            again.file(fname)
+        finally:
+            gyoto.core.fitsMap(mode)
+        if sys.byteorder == 'little':
+            self.assertTrue(os.path.exists(fname+'.hdu1.native'))
+        for disk in (mapped, again):
+            data=gyoto.core.array_double.frompointer(disk.getIntensity())
+            for k in range(nr*nphi*nnu):
+                self.assertEqual(data[k], intensity.flat[k])
+        # Replacing the file right away, with the same size, must not
+        # reuse the cache
+        os.remove(fname)
+        pd.copyIntensity(gyoto.core.array_double.fromnumpy3(intensity+1.),
+                         gyoto.core.array_size_t.fromnumpy1(naxes))
+        pd.fitsWrite(fname)
+        gyoto.core.fitsMap(1)
+        try:
+            replaced=gyoto.std.PatternDisk()
+            replaced.file(fname)
+        finally:
+            gyoto.core.fitsMap(mode)
+        data=gyoto.core.array_double.frompointer(replaced.getIntensity())
+        for k in range(nr*nphi*nnu):
+            self.assertEqual(data[k], intensity.flat[k]+1.)
+        for f in os.listdir(tmpdir):
+            os.remove(os.path.join(tmpdir, f))
+        os.rmdir(tmpdir)
@@ -104,10 +104,103 @@ mdiff=max(abs(diff));
 if (mdiff > 1e-6) error, "Results differ";
 output, " OK (max rel. dif.: "+pr1(mdiff)+")";
 
+doing, "Integrating with MPI in fixed chunks of 7 rays";
+noop, sc.MPIChunkSize(7);
+sc, mpispawn=3, mpiclone=;
+data2=sc();
+sc, mpispawn=0;
+noop, sc.MPIChunkSize(0);
+done;
+
+doing, "Comparing results";
+diff=data-data2;
+ind=where(data);
+diff(ind)/=data(ind);
+mdiff=max(abs(diff));
+if (mdiff > 1e-6) error, "Results differ";
+output, " OK (max rel. dif.: "+pr1(mdiff)+")";
+
+doing, "Integrating with 2 MPI processes of 2 threads each";
+sc, nthreads=2;
+sc, mpispawn=2, mpiclone=;
+data2=sc();
+sc, mpispawn=0;
+done;
+
+doing, "Comparing results";
+diff=data-data2;
+ind=where(data);
+diff(ind)/=data(ind);
+mdiff=max(abs(diff));
+if (mdiff > 1e-6) error, "Results differ";
+output, " OK (max rel. dif.: "+pr1(mdiff)+")";
+
 doing, "Deleting Scenery";
 sc=[];
 done;
 
+if (haveXerces() && haveCFITSIO()) {
+  doing, "Reading a PatternDisk Scenery from a FITS file";
+  opacity=array(double, 11, 3, 1);
+  opacity(1::2, 1::2, )=100.;
+  opacity(2::2, 2::2, )=100.;
+  metric=KerrBL(mass=4e6, unit="sunmass");
+  pd=PatternDisk(copyintensity=opacity*0.+1., copyopacity=opacity,
+                 innerradius=3, outerradius=28, repeatphi=8,
+                 metric=metric, rmax=50);
+  pd, fitswrite="!check-mpi.fits";
+  screen=Screen(metric=metric, resolution=32,
+                time=1000.*metric.unitlength()/GYOTO_C,
+                distance=100.*metric.unitlength(), fov=30./100.,
+                inclination=110./180.*pi, paln=pi);
+  Scenery(metric=metric, screen=screen, astrobj=pd),
+    xmlwrite="check-mpi.xml";
+  sc=Scenery("check-mpi.xml");
+  done;
+
+  doing, "Sending it to the workers with its FITS file";
+  sc, mpispawn=4, mpiclone=;
+  data=sc();
+  sc, mpispawn=0;
+  done;
+
+  doing, "Integrating it without MPI";
+  data2=sc();
+  done;
+
+  doing, "Comparing results";
+  diff=data-data2;
+  ind=where(data);
+  diff(ind)/=data(ind);
+  mdiff=max(abs(diff));
+  if (mdiff > 1e-6) error, "Results differ";
+  output, " OK (max rel. dif.: "+pr1(mdiff)+")";
+
+  doing, "Sending it twice in a row";
+  sc, mpispawn=4, mpiclone=;
+  sc, mpiclone=;
+  data=sc();
+  sc, mpiclone=;
+  data3=sc();
+  sc, mpispawn=0;
+  done;
+
+  doing, "Comparing results";
+  ind=where(data2);
+  mdiff=0.;
+  for (k=1; k<=2; ++k) {
+    diff=(k==1?data:data3)-data2;
+    diff(ind)/=data2(ind);
+    mdiff=max(mdiff, max(abs(diff)));
+  }
+  if (mdiff > 1e-6) error, "Results differ";
+  output, " OK (max rel. dif.: "+pr1(mdiff)+")";
+
+  remove, "check-mpi.xml";
+  remove, "check-mpi.fits";
+  sc=pd=screen=metric=opacity=data3=[];
+ }
+
 doing, "Calling MPI_Finalized";
 if (MPI_Finalized()) error, "MPI should not be finalized yet";
 done;
@@ -131,6 +131,27 @@ for (i=1; i<=N; i++) {
     hitmap(i,j)=ph(is_hit=1);
   }
  }
+
+// Speed of Photon::hit() on a ray grazing the photon ring, which
+// winds around the black hole and needs many integration steps.
+// From yutils, for tic() and tac()
+#include "util_fr.i"
+robs=1000.;
+bcrit=3.*sqrt(3.);
+ringscreen=gyoto_Screen(metric=gg, observerpos=[robs, robs, pi/2., 0.]);
+ph=gyoto_Photon(metric=gg, astrobj=orbit);
+if (gyoto_haveBoost()) ph, integrator="runge_kutta_fehlberg78";
+alpha=asin(bcrit*(1.+1e-6)*sqrt(1.-2./robs)/robs);
+nrep=20;
+tic;
+for (k=1; k<=nrep; ++k) {
+  ph, initcoord=ringscreen, 0., alpha;
+  junk=ph(is_hit=1);
+ }
+t=tac();
+nsteps=dimsof(ph(get_txyz=1))(2);
+write, format="Photon::hit() near photon ring: %i steps, %g s/ray, %g steps/s\n",
+  nsteps, t/nrep, nsteps*nrep/t;
 ph2=[];
 
 
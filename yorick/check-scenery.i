@@ -247,8 +247,58 @@ done;
 
 sc, nthreads=8, nprocesses=0, mpispawn=0;
 
-doing, "Integrating whole field...";
+doing, "Integrating whole field...\n";
+tic;
 data=sc();
+tac();
+done;
+
+doing, "Integrating whole field with work-stealing scheduler...\n";
+noop, sc.Scheduler("WorkStealing");
+noop, sc.TileSize(16);
+tic;
+data2=sc();
+tac();
+done;
+doing, "Comparing...";
+if (anyof(data2 != data)) error, "result differ";
+done;
+noop, sc.Scheduler("Shared");
+
+doing, "Integrating whole field three times with thread pool...\n";
+noop, sc.ThreadPool(1);
+for (k=1; k<=3; ++k) {
+  tic;
+  data2=sc();
+  tac();
+  if (anyof(data2 != data)) error, "result differ";
+ }
+noop, sc.Scheduler("WorkStealing");
+data2=sc();
+if (anyof(data2 != data)) error, "result differ";
+noop, sc.Scheduler("Shared");
+noop, sc.ThreadPool(0);
+done;
+
+// Lock-step packets use their own integrator: compare within tolerance
+doing, "Integrating whole field with packets of 8 rays...\n";
+noop, sc.PacketSize(8);
+tic;
+data2=sc();
+tac();
+noop, sc.PacketSize(1);
+done;
+doing, "Comparing...";
+if (sum(abs(data2-data)) > 1e-2*sum(abs(data))) error, "result differ";
+done;
+
+doing, "Integrating whole field with preallocated Photons...\n";
+noop, sc.PreallocateSteps(65536);
+tic;
+data2=sc();
+tac();
+if (sc.PreallocateSteps() != 65536) error, "PreallocateSteps not set";
+if (anyof(data2 != data)) error, "result differ";
 done;
 
 r1=8:25:4;
@@ -109,6 +109,27 @@ if (!nodisplay) {
   winkill;
  }
 
+// Integration speed, in steps per second, for both Kerr flavours
+// From yutils, for tic() and tac()
+#include "util_fr.i"
+benches=[["KerrBL", "spherical"], ["KerrKS", "cartesian"]];
+for (b=1; b<=2; ++b) {
+  if (b==1) {
+    st=gyoto_Star(radius=0.5, metric=gyoto_KerrBL(spin=0.995),
+                  initcoord=[0, 10.791, 1.5708, 0], [0, 0, 0.0166637]);
+  } else {
+    st=gyoto_Star(radius=0.5, metric=gyoto_KerrKS(spin=0.995),
+                  initcoord=[0, 10.791, 0, 0], [0, 0.18, 0]);
+  }
+  if (gyoto_haveBoost()) st, integrator="runge_kutta_fehlberg78";
+  tic;
+  st, xfill=8000;
+  t=tac();
+  nsteps=dimsof(st(get_txyz=1))(2);
+  write, format="%s (%s): %i steps in %g s, %g steps/s\n",
+    benches(1,b), benches(2,b), nsteps, t, nsteps/t;
+ }
+
 // Free memroy to check with valgrind;
 //data=[];
 //st=[];
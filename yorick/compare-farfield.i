@@ -0,0 +1,73 @@
+/*
+    Copyright 2026 Thibaut Paumard
+
+    This file is part of Gyoto.
+
+    Gyoto is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    Gyoto is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with Gyoto.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+  Compare ray-tracing a star close to Sgr A* from Earth with and
+  without the analytic far-field propagation of the Photons (property
+  FarFieldRadius): number of integration steps, computing time, hit
+  map and date of impact.
+ */
+
+#include "gyoto.i"
+// From yutils, for tic() and tac()
+#include "util_fr.i"
+restore, gyoto;
+
+// Put screen on Earth in KerrBL metric
+met=KerrBL(mass=4e6, unit="sunmass", spin=0.5);
+scr=Screen(metric=met, distance=8, unit="kpc");
+scr, inclination=pi/3;
+scr, time=scr(distance=, unit="kpc"), unit="kpc";
+N=32;
+scr, fov=100.*pi/180/3600/1e6, resolution=N; // 100µas
+
+st=Star(metric=met, radius=1.,
+        initcoord=[0., 6., pi/2, 0.], [0., 0., 6.^-1.5]);
+
+radii=[0., 1e5, 1e4, 1e3];
+nsteps=array(long, numberof(radii));
+ctime=array(double, numberof(radii));
+hits=array(long, N, N, numberof(radii));
+dates=array(double, N, N, numberof(radii));
+
+for (k=1; k<=numberof(radii); ++k) {
+  ph=Photon(metric=met, astrobj=st);
+  noop, ph.FarFieldRadius(radii(k));
+  tic;
+  for (i=1; i<=N; ++i) {
+    for (j=1; j<=N; ++j) {
+      ph, initcoord=scr, i, j;
+      hits(i,j,k)=ph(is_hit=1);
+      txyz=ph(get_txyz=1);
+      nsteps(k)+=dimsof(txyz)(2);
+      dates(i,j,k)=min(txyz(,1));
+    }
+  }
+  ctime(k)=tac();
+ }
+
+write, format="%12s %12s %12s %12s %12s\n",
+  "FarField", "steps/ray", "time [s]", "hit mismatch", "max |dt| [M]";
+for (k=1; k<=numberof(radii); ++k) {
+  both=where(hits(,,k) & hits(,,1));
+  dt=numberof(both) ? max(abs(dates(,,k)(both)-dates(,,1)(both))) : 0.;
+  write, format="%12g %12g %12g %12d %12g\n",
+    radii(k), nsteps(k)/double(N*N), ctime(k),
+    long(sum(hits(,,k)!=hits(,,1))), dt;
+ }
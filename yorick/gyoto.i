@@ -1697,6 +1697,18 @@ extern gyoto_verbose;
    SEE ALSO: gyoto
  */
 
+extern gyoto_fitsMap;
+/* DOCUMENT gyoto.fitsMap, 1/0
+         or mode = gyoto.fitsMap()
+    Set/get FITS mapping mode. When on, the Astrobj kinds that
+    support it (PatternDisk, Disk3D, FlaredDiskSynchrotron,
+    XillverReflection...) map uncompressed double-precision FITS
+    tables into memory instead of reading them. On little-endian
+    machines, a native-endian copy FILE.hduN.native is cached next to
+    each FITS file.
+   SEE ALSO: gyoto
+ */
+
 extern gyoto_Spectrometer;
 /* DOCUMENT spectro = gyoto.Spectrometer([filename],[members=values])
          or spectro, xmlwrite=filename
@@ -26,6 +26,7 @@ gyoto=save(
 
            debug=gyoto_debug,
            verbose=gyoto_verbose,
+           fitsMap=gyoto_fitsMap,
 
            Spectrometer=gyoto_Spectrometer,
            SpectroUniform=gyoto_SpectroUniform,